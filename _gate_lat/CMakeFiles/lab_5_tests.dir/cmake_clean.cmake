@@ -0,0 +1,27 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/lab_5_tests.dir/src/background_reclaimer.cpp.o"
+  "CMakeFiles/lab_5_tests.dir/src/background_reclaimer.cpp.o.d"
+  "CMakeFiles/lab_5_tests.dir/src/complex_type.cpp.o"
+  "CMakeFiles/lab_5_tests.dir/src/complex_type.cpp.o.d"
+  "CMakeFiles/lab_5_tests.dir/src/complex_type_loader.cpp.o"
+  "CMakeFiles/lab_5_tests.dir/src/complex_type_loader.cpp.o.d"
+  "CMakeFiles/lab_5_tests.dir/src/counting_memory_resource.cpp.o"
+  "CMakeFiles/lab_5_tests.dir/src/counting_memory_resource.cpp.o.d"
+  "CMakeFiles/lab_5_tests.dir/src/epoch_domain.cpp.o"
+  "CMakeFiles/lab_5_tests.dir/src/epoch_domain.cpp.o.d"
+  "CMakeFiles/lab_5_tests.dir/src/mapped_file_resource.cpp.o"
+  "CMakeFiles/lab_5_tests.dir/src/mapped_file_resource.cpp.o.d"
+  "CMakeFiles/lab_5_tests.dir/src/memory_resource.cpp.o"
+  "CMakeFiles/lab_5_tests.dir/src/memory_resource.cpp.o.d"
+  "CMakeFiles/lab_5_tests.dir/tests/heap_allocation_counter.cpp.o"
+  "CMakeFiles/lab_5_tests.dir/tests/heap_allocation_counter.cpp.o.d"
+  "CMakeFiles/lab_5_tests.dir/tests/tests.cpp.o"
+  "CMakeFiles/lab_5_tests.dir/tests/tests.cpp.o.d"
+  "lab_5_tests"
+  "lab_5_tests.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/lab_5_tests.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,26 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/src/background_reclaimer.cpp" "CMakeFiles/lab_5.dir/src/background_reclaimer.cpp.o" "gcc" "CMakeFiles/lab_5.dir/src/background_reclaimer.cpp.o.d"
+  "/root/repo/src/complex_type.cpp" "CMakeFiles/lab_5.dir/src/complex_type.cpp.o" "gcc" "CMakeFiles/lab_5.dir/src/complex_type.cpp.o.d"
+  "/root/repo/src/complex_type_loader.cpp" "CMakeFiles/lab_5.dir/src/complex_type_loader.cpp.o" "gcc" "CMakeFiles/lab_5.dir/src/complex_type_loader.cpp.o.d"
+  "/root/repo/src/counting_memory_resource.cpp" "CMakeFiles/lab_5.dir/src/counting_memory_resource.cpp.o" "gcc" "CMakeFiles/lab_5.dir/src/counting_memory_resource.cpp.o.d"
+  "/root/repo/src/epoch_domain.cpp" "CMakeFiles/lab_5.dir/src/epoch_domain.cpp.o" "gcc" "CMakeFiles/lab_5.dir/src/epoch_domain.cpp.o.d"
+  "/root/repo/src/main.cpp" "CMakeFiles/lab_5.dir/src/main.cpp.o" "gcc" "CMakeFiles/lab_5.dir/src/main.cpp.o.d"
+  "/root/repo/src/mapped_file_resource.cpp" "CMakeFiles/lab_5.dir/src/mapped_file_resource.cpp.o" "gcc" "CMakeFiles/lab_5.dir/src/mapped_file_resource.cpp.o.d"
+  "/root/repo/src/memory_resource.cpp" "CMakeFiles/lab_5.dir/src/memory_resource.cpp.o" "gcc" "CMakeFiles/lab_5.dir/src/memory_resource.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
@@ -0,0 +1,25 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/lab_5.dir/src/background_reclaimer.cpp.o"
+  "CMakeFiles/lab_5.dir/src/background_reclaimer.cpp.o.d"
+  "CMakeFiles/lab_5.dir/src/complex_type.cpp.o"
+  "CMakeFiles/lab_5.dir/src/complex_type.cpp.o.d"
+  "CMakeFiles/lab_5.dir/src/complex_type_loader.cpp.o"
+  "CMakeFiles/lab_5.dir/src/complex_type_loader.cpp.o.d"
+  "CMakeFiles/lab_5.dir/src/counting_memory_resource.cpp.o"
+  "CMakeFiles/lab_5.dir/src/counting_memory_resource.cpp.o.d"
+  "CMakeFiles/lab_5.dir/src/epoch_domain.cpp.o"
+  "CMakeFiles/lab_5.dir/src/epoch_domain.cpp.o.d"
+  "CMakeFiles/lab_5.dir/src/main.cpp.o"
+  "CMakeFiles/lab_5.dir/src/main.cpp.o.d"
+  "CMakeFiles/lab_5.dir/src/mapped_file_resource.cpp.o"
+  "CMakeFiles/lab_5.dir/src/mapped_file_resource.cpp.o.d"
+  "CMakeFiles/lab_5.dir/src/memory_resource.cpp.o"
+  "CMakeFiles/lab_5.dir/src/memory_resource.cpp.o.d"
+  "lab_5"
+  "lab_5.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/lab_5.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,25 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/lab_5_bench.dir/bench/benchmarks.cpp.o"
+  "CMakeFiles/lab_5_bench.dir/bench/benchmarks.cpp.o.d"
+  "CMakeFiles/lab_5_bench.dir/src/background_reclaimer.cpp.o"
+  "CMakeFiles/lab_5_bench.dir/src/background_reclaimer.cpp.o.d"
+  "CMakeFiles/lab_5_bench.dir/src/complex_type.cpp.o"
+  "CMakeFiles/lab_5_bench.dir/src/complex_type.cpp.o.d"
+  "CMakeFiles/lab_5_bench.dir/src/complex_type_loader.cpp.o"
+  "CMakeFiles/lab_5_bench.dir/src/complex_type_loader.cpp.o.d"
+  "CMakeFiles/lab_5_bench.dir/src/counting_memory_resource.cpp.o"
+  "CMakeFiles/lab_5_bench.dir/src/counting_memory_resource.cpp.o.d"
+  "CMakeFiles/lab_5_bench.dir/src/epoch_domain.cpp.o"
+  "CMakeFiles/lab_5_bench.dir/src/epoch_domain.cpp.o.d"
+  "CMakeFiles/lab_5_bench.dir/src/mapped_file_resource.cpp.o"
+  "CMakeFiles/lab_5_bench.dir/src/mapped_file_resource.cpp.o.d"
+  "CMakeFiles/lab_5_bench.dir/src/memory_resource.cpp.o"
+  "CMakeFiles/lab_5_bench.dir/src/memory_resource.cpp.o.d"
+  "lab_5_bench"
+  "lab_5_bench.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/lab_5_bench.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,620 @@
+#include "../include/memory_resource.h"
+#include "../include/background_reclaimer.h"
+#include "../include/dynamic_array.h"
+#include "../include/complex_type.h"
+#include "../include/complex_type_loader.h"
+#include "../include/counting_memory_resource.h"
+#include "../include/monotonic_arena.h"
+#include "../include/snapshot_array.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <shared_mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double seconds_since(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// ==================== False sharing: счётчики потоков ====================
+
+// Каждый поток увеличивает собственный элемент массива; возвращает
+// суммарную пропускную способность в инкрементах в секунду
+template<typename Array>
+double run_counters(Array& counters, std::size_t iterations) {
+    std::vector<std::thread> threads;
+    auto start = Clock::now();
+    for (auto it = counters.begin(); it != counters.end(); ++it) {
+        volatile std::uint64_t* counter = &*it;
+        threads.emplace_back([counter, iterations] {
+            for (std::size_t i = 0; i < iterations; ++i) {
+                *counter = *counter + 1;
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    double elapsed = seconds_since(start);
+    return static_cast<double>(iterations * counters.size()) / elapsed;
+}
+
+void bench_false_sharing() {
+    const std::size_t thread_count = std::max(2u, std::thread::hardware_concurrency());
+    const std::size_t iterations = 50'000'000;
+
+    std::cout << "\n=== False sharing: " << thread_count << " threads x "
+              << iterations << " increments ===" << std::endl;
+
+    {
+        DynamicBlockMemoryResource resource(AllocationMode::Packed);
+        resource.set_logging(false);
+        DynamicArray<std::uint64_t> counters{std::pmr::polymorphic_allocator<std::uint64_t>(&resource)};
+        for (std::size_t i = 0; i < thread_count; ++i) {
+            counters.push_back(0);
+        }
+        std::cout << "Packed layout:     " << run_counters(counters, iterations) / 1e6
+                  << " M increments/s" << std::endl;
+    }
+
+    {
+        DynamicBlockMemoryResource resource(AllocationMode::CacheLineAligned);
+        resource.set_logging(false);
+        DynamicArray<std::uint64_t, CacheLineLayout> counters{
+            std::pmr::polymorphic_allocator<std::uint64_t>(&resource)};
+        for (std::size_t i = 0; i < thread_count; ++i) {
+            counters.push_back(0);
+        }
+        std::cout << "Cache-line layout: " << run_counters(counters, iterations) / 1e6
+                  << " M increments/s" << std::endl;
+    }
+}
+
+// ==================== Потоковая загрузка ComplexType ====================
+
+void report_load(const char* label, const LoadStats& stats) {
+    std::cout << label << stats.records << " records, "
+              << stats.records_per_second() / 1e6 << " M records/s, "
+              << stats.megabytes_per_second() << " MB/s" << std::endl;
+}
+
+void bench_loader() {
+    const int record_count = 1'000'000;
+    ComplexType::set_logging(false);
+
+    std::cout << "\n=== ComplexTypeLoader: " << record_count << " records ===" << std::endl;
+
+    std::string csv;
+    std::ostringstream binary;
+    for (int i = 0; i < record_count; ++i) {
+        std::string name = "record_" + std::to_string(i);
+        csv += std::to_string(i) + ',' + name + ',' + std::to_string(i * 0.25) + ','
+             + std::to_string(i) + ',' + std::to_string(i * 2) + ',' + std::to_string(i * 3) + '\n';
+        write_binary_record(binary, ComplexType(i, name, i * 0.25));
+    }
+
+    {
+        DynamicBlockMemoryResource resource;
+        resource.set_logging(false);
+        DynamicArray<ComplexType> array{std::pmr::polymorphic_allocator<ComplexType>(&resource)};
+        std::istringstream in(csv);
+        report_load("CSV into array:      ", ComplexTypeLoader().load(in, array));
+    }
+
+    {
+        DynamicBlockMemoryResource resource;
+        resource.set_logging(false);
+        DynamicArray<ComplexType> array{std::pmr::polymorphic_allocator<ComplexType>(&resource)};
+        std::istringstream in(binary.str());
+        report_load("Binary into array:   ", 
+                    ComplexTypeLoader(ComplexTypeLoader::Format::Binary).load(in, array));
+    }
+
+    {
+        DynamicBlockMemoryResource resource;
+        resource.set_logging(false);
+        std::istringstream in(csv);
+        std::size_t total = 0;
+        LoadStats stats = ComplexTypeLoader().load_batches(in, [&total](DynamicArray<ComplexType>& batch) {
+            total += batch.size();
+        }, std::pmr::polymorphic_allocator<ComplexType>(&resource));
+        report_load("CSV batches (bounded): ", stats);
+    }
+
+    ComplexType::set_logging(true);
+}
+
+// ==================== Отложенное уничтожение ====================
+
+void fill_complex(DynamicArray<ComplexType>& array, int count) {
+    for (int i = 0; i < count; ++i) {
+        array.emplace_back(i, "element_with_a_heap_allocated_name_" + std::to_string(i), i * 0.5);
+    }
+}
+
+void bench_deferred_destruction() {
+    const int element_count = 500'000;
+    ComplexType::set_logging(false);
+
+    std::cout << "\n=== Teardown of DynamicArray<ComplexType> with " << element_count
+              << " elements ===" << std::endl;
+
+    DynamicBlockMemoryResource resource;
+    resource.set_logging(false);
+    std::pmr::polymorphic_allocator<ComplexType> alloc(&resource);
+
+    {
+        auto array = std::make_unique<DynamicArray<ComplexType>>(alloc);
+        fill_complex(*array, element_count);
+        auto start = Clock::now();
+        array.reset();
+        std::cout << "Inline destructor:   caller blocked " << seconds_since(start) * 1e3
+                  << " ms" << std::endl;
+    }
+
+    {
+        BackgroundReclaimer reclaimer;
+        auto array = std::make_unique<DynamicArray<ComplexType>>(alloc);
+        array->set_reclaimer(&reclaimer);
+        fill_complex(*array, element_count);
+        auto start = Clock::now();
+        array.reset();
+        std::cout << "Deferred destructor: caller blocked " << seconds_since(start) * 1e3
+                  << " ms" << std::endl;
+        start = Clock::now();
+        reclaimer.drain();
+        std::cout << "Background reclaim finished after " << seconds_since(start) * 1e3
+                  << " ms" << std::endl;
+    }
+
+    ComplexType::set_logging(true);
+}
+
+// ==================== Copy-on-write ====================
+
+// Массив передаётся по значению через несколько "модулей", которые только читают
+long long read_only_pipeline(DynamicArray<int> array, int depth) {
+    if (depth == 0) {
+        long long sum = 0;
+        for (auto it = array.cbegin(); it != array.cend(); ++it) {
+            sum += *it;
+        }
+        return sum;
+    }
+    return read_only_pipeline(array, depth - 1);
+}
+
+void bench_copy_on_write() {
+    const int element_count = 10'000;
+    const int calls = 50;
+    const int depth = 4;
+
+    std::cout << "\n=== Pass-by-value of DynamicArray<int> with " << element_count
+              << " elements, " << calls << " calls x depth " << depth << " ===" << std::endl;
+
+    for (bool cow : {false, true}) {
+        DynamicBlockMemoryResource resource;
+        resource.set_logging(false);
+        DynamicArray<int> array{std::pmr::polymorphic_allocator<int>(&resource)};
+        array.set_copy_on_write(cow);
+        for (int i = 0; i < element_count; ++i) {
+            array.push_back(i);
+        }
+
+        long long checksum = 0;
+        auto start = Clock::now();
+        for (int i = 0; i < calls; ++i) {
+            checksum += read_only_pipeline(array, depth);
+        }
+        double elapsed = seconds_since(start);
+        std::cout << (cow ? "Copy-on-write: " : "Deep copy:     ") << elapsed * 1e3
+                  << " ms (checksum " << checksum << ")" << std::endl;
+    }
+}
+
+// ==================== Partition: splice против копирования ====================
+
+void bench_splice_partition() {
+    const int element_count = 200'000;
+
+    std::cout << "\n=== Partition of DynamicArray<ComplexType> with " << element_count
+              << " elements into even/odd ids ===" << std::endl;
+    ComplexType::set_logging(false);
+
+    DynamicBlockMemoryResource resource;
+    resource.set_logging(false);
+    std::pmr::polymorphic_allocator<ComplexType> alloc(&resource);
+
+    {
+        DynamicArray<ComplexType> source(alloc);
+        fill_complex(source, element_count);
+        DynamicArray<ComplexType> even(alloc);
+        DynamicArray<ComplexType> odd(alloc);
+        auto start = Clock::now();
+        for (auto it = source.cbegin(); it != source.cend(); ++it) {
+            (it->id % 2 == 0 ? even : odd).push_back(*it);
+        }
+        source.clear();
+        std::cout << "Copy into new arrays: " << seconds_since(start) * 1e3 << " ms" << std::endl;
+    }
+
+    {
+        DynamicArray<ComplexType> source(alloc);
+        fill_complex(source, element_count);
+        DynamicArray<ComplexType> even(alloc);
+        DynamicArray<ComplexType> odd(alloc);
+        auto even_tail = even.cbefore_begin();
+        auto odd_tail = odd.cbefore_begin();
+        auto start = Clock::now();
+        while (!source.empty()) {
+            bool is_even = source.cbegin()->id % 2 == 0;
+            auto& target = is_even ? even : odd;
+            auto& tail = is_even ? even_tail : odd_tail;
+            target.splice_after(tail, source, source.cbefore_begin());
+            ++tail;
+        }
+        std::cout << "Splice nodes:         " << seconds_since(start) * 1e3 << " ms" << std::endl;
+    }
+
+    ComplexType::set_logging(true);
+}
+
+// ==================== Компактизация ====================
+
+double scan_values(const DynamicArray<ComplexType>& array, int repeats) {
+    double sum = 0.0;
+    auto start = Clock::now();
+    for (int r = 0; r < repeats; ++r) {
+        for (const auto& item : array) {
+            sum += item.value;
+        }
+    }
+    double elapsed = seconds_since(start);
+    if (sum < 0) {
+        std::cout << sum;
+    }
+    return elapsed / repeats;
+}
+
+void bench_compaction() {
+    const int element_count = 200'000;
+    const int scans = 10;
+
+    std::cout << "\n=== Scan of DynamicArray<ComplexType> with " << element_count
+              << " elements before/after compact() ===" << std::endl;
+    ComplexType::set_logging(false);
+
+    {
+        DynamicBlockMemoryResource resource;
+        resource.set_logging(false);
+        std::pmr::polymorphic_allocator<ComplexType> alloc(&resource);
+
+        // Имитация долгой работы: элементы раскладываются по нескольким массивам
+        // вперемешку и затем сливаются, так что соседние элементы оказываются
+        // далеко друг от друга в памяти
+        const int buckets = 16;
+        std::vector<DynamicArray<ComplexType>> parts;
+        for (int b = 0; b < buckets; ++b) {
+            parts.emplace_back(alloc);
+        }
+        unsigned state = 12345;
+        for (int i = 0; i < element_count; ++i) {
+            state = state * 1103515245u + 12345u;
+            parts[(state >> 16) % buckets].emplace_back(i, "item", i * 0.5);
+        }
+        DynamicArray<ComplexType> array(alloc);
+        for (auto& part : parts) {
+            auto last = array.cbefore_begin();
+            for (auto it = array.cbegin(); it != array.cend(); ++it) {
+                last = it;
+            }
+            array.splice_after(last, part);
+        }
+
+        double before = scan_values(array, scans);
+        CompactionReport report = array.compact();
+        double after = scan_values(array, scans);
+
+        std::cout << "Scan before: " << before * 1e3 << " ms, after: " << after * 1e3 << " ms ("
+                  << before / after << "x)" << std::endl;
+        std::cout << "Mean neighbour gap: " << report.mean_gap_before << " -> "
+                  << report.mean_gap_after << " bytes (locality gain "
+                  << report.locality_gain() << "x)" << std::endl;
+    }
+
+    ComplexType::set_logging(true);
+}
+
+// ==================== Снимки для читателей ====================
+
+struct ReaderWriterResult {
+    double writes_per_second;
+    double scans_per_second;
+};
+
+// Писатель дописывает write_count элементов, поддерживая окно фиксированного
+// размера, reader_count читателей всё это время обходят массив с короткой
+// паузой между обходами, как потоки мониторинга (без паузы читатели
+// shared_mutex могут не пустить писателя вовсе); write(i) и scan()
+// определяют способ синхронизации
+template<typename Write, typename Scan>
+ReaderWriterResult run_readers_and_writer(std::size_t reader_count, long long write_count,
+                                          Write write, Scan scan) {
+    std::atomic<bool> done{false};
+    std::atomic<long long> scans{0};
+    std::vector<std::thread> readers;
+    for (std::size_t r = 0; r < reader_count; ++r) {
+        readers.emplace_back([&] {
+            long long local = 0;
+            while (!done.load(std::memory_order_relaxed)) {
+                scan();
+                local++;
+                std::this_thread::sleep_for(std::chrono::microseconds(200));
+            }
+            scans += local;
+        });
+    }
+
+    auto start = Clock::now();
+    for (long long i = 0; i < write_count; ++i) {
+        write(i);
+    }
+    done.store(true);
+    for (auto& reader : readers) {
+        reader.join();
+    }
+    double elapsed = seconds_since(start);
+    return {static_cast<double>(write_count) / elapsed, static_cast<double>(scans.load()) / elapsed};
+}
+
+void bench_snapshot_readers() {
+    const std::size_t window = 10'000;
+    const std::size_t reader_count = 3;
+    const long long write_count = 1'000'000;
+
+    std::cout << "\n=== One writer (window of " << window << " ints) and " << reader_count
+              << " scanning readers ===" << std::endl;
+
+    auto print = [](const char* name, const ReaderWriterResult& result) {
+        std::cout << name << result.writes_per_second / 1e6 << " M writes/s, "
+                  << result.scans_per_second << " scans/s" << std::endl;
+    };
+
+    {
+        DynamicArray<int> array;
+        std::shared_mutex mutex;
+        std::atomic<long long> sink{0};
+        auto result = run_readers_and_writer(
+            reader_count, write_count,
+            [&](long long i) {
+                std::unique_lock<std::shared_mutex> lock(mutex);
+                array.push_back(static_cast<int>(i));
+                if (array.size() > window) {
+                    array.pop_front();
+                }
+            },
+            [&] {
+                std::shared_lock<std::shared_mutex> lock(mutex);
+                long long sum = 0;
+                for (auto it = array.cbegin(); it != array.cend(); ++it) {
+                    sum += *it;
+                }
+                sink += sum == -1;
+            });
+        print("DynamicArray + shared_mutex: ", result);
+    }
+
+    {
+        SnapshotArray<int> array;
+        std::atomic<long long> sink{0};
+        auto result = run_readers_and_writer(
+            reader_count, write_count,
+            [&](long long i) {
+                array.push_back(static_cast<int>(i));
+                if (array.size() > window) {
+                    array.pop_front();
+                }
+            },
+            [&] {
+                auto snapshot = array.snapshot();
+                long long sum = 0;
+                for (int value : snapshot) {
+                    sum += value;
+                }
+                sink += sum == -1;
+            });
+        print("SnapshotArray (epochs):      ", result);
+    }
+}
+
+// ==================== Пакетное выделение ====================
+
+// Переадресует вызовы другому ресурсу, скрывая его пакетный интерфейс:
+// контейнер вынужден выделять и освобождать элементы по одному
+class PerBlockResource : public std::pmr::memory_resource {
+private:
+    std::pmr::memory_resource* target_;
+
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+        return target_->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void* ptr, std::size_t bytes, std::size_t alignment) override {
+        target_->deallocate(ptr, bytes, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+
+public:
+    explicit PerBlockResource(std::pmr::memory_resource* target) : target_(target) {}
+};
+
+// Время копирования и очистки копии массива из element_count элементов
+void measure_copy(const char* name, std::pmr::memory_resource* resource, int element_count) {
+    DynamicArray<int> source{std::pmr::polymorphic_allocator<int>(resource)};
+    for (int i = 0; i < element_count; ++i) {
+        source.push_back(i);
+    }
+
+    auto start = Clock::now();
+    DynamicArray<int> copy(source);
+    double copy_time = seconds_since(start);
+    start = Clock::now();
+    copy.clear();
+    double clear_time = seconds_since(start);
+
+    std::cout << name << "copy " << copy_time * 1e3 << " ms, clear " << clear_time * 1e3
+              << " ms" << std::endl;
+}
+
+void bench_bulk_copy() {
+    const int element_count = 1'000'000;
+
+    std::cout << "\n=== Copy and clear of DynamicArray<int> with " << element_count
+              << " elements on DynamicBlockMemoryResource ===" << std::endl;
+
+    DynamicBlockMemoryResource resource;
+    resource.set_logging(false);
+    PerBlockResource per_block(&resource);
+
+    measure_copy("Per-element allocate/deallocate: ", &per_block, element_count);
+    measure_copy("allocate_bulk/deallocate_bulk:   ", &resource, element_count);
+}
+
+// ==================== Пул повторного использования ====================
+
+// Очередь фиксированной длины: pop_front + emplace_back operations раз
+void measure_churn(const char* name, std::size_t pool, int window, int operations) {
+    CountingMemoryResource resource(std::pmr::new_delete_resource());
+    DynamicArray<ComplexType> queue{std::pmr::polymorphic_allocator<ComplexType>(&resource)};
+    queue.set_recycling(pool);
+    const std::string label = "churn_element_with_a_heap_allocated_name";
+    for (int i = 0; i < window; ++i) {
+        queue.emplace_back(i, label, i * 0.5);
+    }
+
+    std::size_t before = resource.allocations();
+    auto start = Clock::now();
+    for (int i = window; i < window + operations; ++i) {
+        queue.pop_front();
+        queue.emplace_back(i, label, i * 0.5);
+    }
+    double elapsed = seconds_since(start);
+
+    std::cout << name << static_cast<double>(resource.allocations() - before) / operations
+              << " allocations/op, " << elapsed * 1e9 / operations << " ns/op" << std::endl;
+}
+
+void bench_recycling() {
+    const int window = 1024;
+    const int operations = 2'000'000;
+    ComplexType::set_logging(false);
+
+    std::cout << "\n=== Queue churn of DynamicArray<ComplexType>, window " << window
+              << ", " << operations << " operations ===" << std::endl;
+
+    measure_churn("Destroy and allocate: ", 0, window, operations);
+    measure_churn("Recycling pool:       ", 64, window, operations);
+
+    ComplexType::set_logging(true);
+}
+
+// ==================== Политики DynamicArray ====================
+
+// Время заполнения массива, обхода и уничтожения; make создаёт пустой массив
+template<typename MakeArray>
+void measure_policy(const char* name, MakeArray make, int element_count, int rounds) {
+    long long sum = 0;
+    auto start = Clock::now();
+    for (int round = 0; round < rounds; ++round) {
+        auto array = make();
+        for (int i = 0; i < element_count; ++i) {
+            array.push_back(i);
+        }
+        for (int value : array) {
+            sum += value;
+        }
+    }
+    double elapsed = seconds_since(start);
+    std::cout << name << elapsed * 1e9 / (static_cast<double>(element_count) * rounds)
+              << " ns/element (checksum " << sum << ")" << std::endl;
+}
+
+void bench_policies() {
+    const int element_count = 100'000;
+    const int rounds = 20;
+
+    std::cout << "\n=== push_back + traversal + destruction of " << element_count
+              << " ints, " << rounds << " rounds ===" << std::endl;
+
+    DynamicBlockMemoryResource block_resource;
+    block_resource.set_logging(false);
+    measure_policy("pmr, DynamicBlockMemoryResource:    ", [&] {
+        return DynamicArray<int>{std::pmr::polymorphic_allocator<int>(&block_resource)};
+    }, element_count, rounds);
+
+    std::pmr::monotonic_buffer_resource pmr_arena;
+    measure_policy("pmr, monotonic_buffer_resource:     ", [&] {
+        pmr_arena.release();
+        return DynamicArray<int>{std::pmr::polymorphic_allocator<int>(&pmr_arena)};
+    }, element_count, rounds);
+
+    MonotonicArena arena;
+    measure_policy("ResourceAllocation<MonotonicArena>: ", [&] {
+        arena.release();
+        return DynamicArray<int, ResourceAllocation<MonotonicArena>, UncheckedAccess>{
+            ResourceAllocator<int, MonotonicArena>(&arena)};
+    }, element_count, rounds);
+
+    measure_policy("StdAllocation:                      ", [] {
+        return DynamicArray<int, StdAllocation, UncheckedAccess>{};
+    }, element_count, rounds);
+}
+
+struct Benchmark {
+    const char* name;
+    void (*run)();
+};
+
+const Benchmark benchmarks[] = {
+    {"false_sharing", bench_false_sharing},
+    {"loader", bench_loader},
+    {"deferred_destruction", bench_deferred_destruction},
+    {"copy_on_write", bench_copy_on_write},
+    {"splice_partition", bench_splice_partition},
+    {"compaction", bench_compaction},
+    {"snapshot_readers", bench_snapshot_readers},
+    {"bulk_copy", bench_bulk_copy},
+    {"recycling", bench_recycling},
+    {"policies", bench_policies},
+};
+
+} // namespace
+
+int main(int argc, char** argv) {
+    // Без аргументов запускаются все бенчмарки, иначе только перечисленные
+    for (const auto& benchmark : benchmarks) {
+        bool selected = argc < 2;
+        for (int i = 1; i < argc; ++i) {
+            if (std::strcmp(argv[i], benchmark.name) == 0) {
+                selected = true;
+            }
+        }
+        if (selected) {
+            benchmark.run();
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+// Задание на отложенное освобождение памяти
+class ReclaimJob {
+public:
+    virtual ~ReclaimJob() = default;
+
+    // Освобождает не более max_items объектов; возвращает true, когда
+    // задание выполнено полностью
+    virtual bool run(std::size_t max_items) = 0;
+};
+
+// Фоновый поток, который уничтожает отсоединённые данные контейнеров.
+//
+// Задания выполняются порциями по batch_size объектов по кругу, так что
+// одно большое задание не задерживает остальные. Память, освобождаемая
+// заданиями, возвращается в исходный memory_resource, поэтому ресурс должен
+// быть потокобезопасным и жить дольше всех отправленных в него заданий:
+// перед уничтожением ресурса нужно вызвать drain().
+class BackgroundReclaimer {
+private:
+    std::deque<std::unique_ptr<ReclaimJob>> jobs_;
+    std::size_t batch_size_;
+    std::size_t running_;
+    bool stopping_;
+    mutable std::mutex mutex_;
+    std::condition_variable work_available_;
+    std::condition_variable idle_;
+    std::thread worker_;
+
+    void worker_loop();
+
+public:
+    explicit BackgroundReclaimer(std::size_t batch_size = 1024);
+
+    BackgroundReclaimer(const BackgroundReclaimer&) = delete;
+    BackgroundReclaimer& operator=(const BackgroundReclaimer&) = delete;
+
+    // Дожидается выполнения всех заданий и останавливает поток
+    ~BackgroundReclaimer();
+
+    // Ставит задание в очередь; O(1) для вызывающего потока
+    void submit(std::unique_ptr<ReclaimJob> job);
+
+    // Блокируется, пока все отправленные задания не будут выполнены
+    void drain();
+
+    // Число ещё не выполненных заданий
+    std::size_t pending() const;
+
+    std::size_t batch_size() const;
+};
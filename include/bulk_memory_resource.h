@@ -0,0 +1,35 @@
+#pragma once
+
+#include <memory_resource>
+#include <cstddef>
+
+// memory_resource, умеющий выделять и освобождать сразу много блоков
+// одинакового размера за один вызов. Контейнеры проверяют поддержку через
+// as_bulk_resource() и при её отсутствии работают поблочно.
+//
+// Блоки, полученные allocate_bulk(), можно освобождать и по одному через
+// deallocate(), и пачками через deallocate_bulk(), в любом порядке.
+class BulkMemoryResource : public std::pmr::memory_resource {
+public:
+    // Записывает в out адреса count блоков по bytes байт с выравниванием alignment
+    void allocate_bulk(std::size_t count, std::size_t bytes, std::size_t alignment, void** out) {
+        do_allocate_bulk(count, bytes, alignment, out);
+    }
+
+    // Освобождает count блоков, выделенных с теми же bytes и alignment
+    void deallocate_bulk(std::size_t count, std::size_t bytes, std::size_t alignment,
+                         void* const* ptrs) {
+        do_deallocate_bulk(count, bytes, alignment, ptrs);
+    }
+
+protected:
+    virtual void do_allocate_bulk(std::size_t count, std::size_t bytes, std::size_t alignment,
+                                  void** out) = 0;
+    virtual void do_deallocate_bulk(std::size_t count, std::size_t bytes, std::size_t alignment,
+                                    void* const* ptrs) = 0;
+};
+
+// Ресурс с пакетным интерфейсом или nullptr
+inline BulkMemoryResource* as_bulk_resource(std::pmr::memory_resource* resource) {
+    return dynamic_cast<BulkMemoryResource*>(resource);
+}
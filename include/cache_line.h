@@ -0,0 +1,21 @@
+#pragma once
+
+#include <new>
+#include <cstddef>
+
+// Размер, на который нужно разносить данные, изменяемые разными потоками,
+// чтобы они не попадали в одну кэш-линию (false sharing).
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Winterference-size"
+#endif
+
+#ifdef __cpp_lib_hardware_interference_size
+inline constexpr std::size_t cache_line_size = std::hardware_destructive_interference_size;
+#else
+inline constexpr std::size_t cache_line_size = 64;
+#endif
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
@@ -1,17 +1,53 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <memory_resource>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <iostream>
 
+// Allocator-aware тип: name и data берут память из того же memory_resource,
+// что и сам объект. polymorphic_allocator::construct (а значит и
+// DynamicArray) передаёт свой аллокатор последним аргументом конструктора
+// (uses-allocator construction), поэтому весь граф объекта живёт в ресурсе
+// контейнера. Копия без явного аллокатора использует ресурс по умолчанию.
 struct ComplexType {
+    using allocator_type = std::pmr::polymorphic_allocator<char>;
+    
     int id;
-    std::string name;
+    std::pmr::string name;
     double value;
-    std::vector<int> data;
+    std::pmr::vector<int> data;
     
-    ComplexType(int i = 0, std::string n = "", double v = 0.0);
-    ComplexType(const ComplexType& other);
+    ComplexType(int i = 0, std::string_view n = {}, double v = 0.0, 
+                const allocator_type& alloc = {});
+    // Формы uses-allocator construction, которым не подходит аллокатор
+    // последним аргументом: только аллокатор и префикс allocator_arg
+    // (emplace_back(), emplace_back(id, name))
+    explicit ComplexType(const allocator_type& alloc);
+    ComplexType(std::allocator_arg_t, const allocator_type& alloc,
+                int i = 0, std::string_view n = {}, double v = 0.0);
+    ComplexType(const ComplexType& other, const allocator_type& alloc = {});
+    ComplexType(ComplexType&& other) noexcept;
+    ComplexType(ComplexType&& other, const allocator_type& alloc);
     ComplexType& operator=(const ComplexType& other);
+    // Не noexcept: при разных ресурсах строка и вектор копируются
+    ComplexType& operator=(ComplexType&& other);
     ~ComplexType();
     
+    allocator_type get_allocator() const;
+    
+    // Повторная инициализация с теми же аргументами, что у конструктора, в
+    // уже выделенной памяти name и data (используется пулом DynamicArray)
+    void reassign(int i, std::string_view n = {}, double v = 0.0);
+    
     void print() const;
+    
+    // Включение/отключение сообщения о каждом уничтожении объекта
+    static void set_logging(bool enabled);
+    
+private:
+    static std::atomic<bool> logging_;
 };
\ No newline at end of file
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <iosfwd>
+#include <memory_resource>
+
+#include "complex_type.h"
+#include "dynamic_array.h"
+
+// Статистика одной загрузки
+struct LoadStats {
+    std::size_t records = 0;
+    std::size_t bytes = 0;
+    double seconds = 0.0;
+
+    double records_per_second() const;
+    double megabytes_per_second() const;
+};
+
+// Потоковый загрузчик записей ComplexType из файлов и пайпов.
+//
+// Вход читается блоками фиксированного размера и разбирается прямо в буфере
+// через std::from_chars, записи создаются сразу в памяти DynamicArray через
+// emplace_back без временных объектов.
+//
+// Форматы:
+//   Csv    - строка "id,name,value[,d0,d1,...]"; если данных нет, data остаётся
+//            значением по умолчанию из конструктора. Имя не может содержать
+//            запятые, пустые строки пропускаются.
+//   Binary - int32 id, uint32 длина имени, байты имени, double value,
+//            uint32 число элементов data, int32 * число элементов
+//            (порядок байт платформы, см. write_binary_record).
+class ComplexTypeLoader {
+public:
+    enum class Format { Csv, Binary };
+
+    using BatchHandler = std::function<void(DynamicArray<ComplexType>&)>;
+
+    explicit ComplexTypeLoader(Format format = Format::Csv,
+                               std::size_t block_size = 1 << 20,
+                               std::size_t batch_size = 4096);
+
+    // Добавляет все записи потока в конец out
+    LoadStats load(std::istream& in, DynamicArray<ComplexType>& out) const;
+
+    // Передаёт записи обработчику пачками не более batch_size штук; после
+    // вызова пачка очищается, поэтому память ограничена размером блока и
+    // пачки даже на бесконечных пайпах
+    LoadStats load_batches(std::istream& in, const BatchHandler& on_batch,
+                           std::pmr::polymorphic_allocator<ComplexType> alloc = {}) const;
+
+    Format format() const;
+    std::size_t block_size() const;
+    std::size_t batch_size() const;
+
+private:
+    Format format_;
+    std::size_t block_size_;
+    std::size_t batch_size_;
+};
+
+// Записывает одну запись в двоичном формате загрузчика
+void write_binary_record(std::ostream& out, const ComplexType& item);
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <memory_resource>
+#include <mutex>
+#include <cstddef>
+
+// memory_resource для проверки бюджета выделений: переадресует вызовы
+// upstream-ресурсу и ведёт счёт выделений, освобождений и байт. Его можно
+// передать контейнеру напрямую или поставить upstream-ресурсом другого
+// ресурса, чтобы считать обращения того к upstream.
+//
+// Проверки: освобождение большего числа блоков или байт, чем выделено,
+// бросает std::runtime_error; выделение сверх бюджета
+// (set_allocation_budget) бросает std::bad_alloc. Потокобезопасен.
+class CountingMemoryResource : public std::pmr::memory_resource {
+public:
+    // Значения счётчиков; разность двух снимков - расход между ними
+    struct Counters {
+        std::size_t allocations = 0;
+        std::size_t deallocations = 0;
+        std::size_t bytes_allocated = 0;
+        std::size_t bytes_deallocated = 0;
+
+        std::size_t live_blocks() const;
+        std::size_t live_bytes() const;
+
+        Counters operator-(const Counters& earlier) const;
+    };
+
+    static constexpr std::size_t unlimited = static_cast<std::size_t>(-1);
+
+private:
+    std::pmr::memory_resource* upstream_;
+    Counters counters_;
+    std::size_t peak_bytes_;
+    std::size_t budget_;          // сколько ещё выделений разрешено
+    mutable std::mutex mutex_;
+
+protected:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+    void do_deallocate(void* ptr, std::size_t bytes, std::size_t alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+public:
+    explicit CountingMemoryResource(std::pmr::memory_resource* upstream =
+                                    std::pmr::get_default_resource());
+
+    CountingMemoryResource(const CountingMemoryResource&) = delete;
+    CountingMemoryResource& operator=(const CountingMemoryResource&) = delete;
+
+    Counters counters() const;
+    std::size_t allocations() const;
+    std::size_t deallocations() const;
+    std::size_t live_blocks() const;
+    std::size_t live_bytes() const;
+    std::size_t peak_bytes() const;
+
+    // Разрешает ещё не более count выделений; unlimited снимает ограничение
+    void set_allocation_budget(std::size_t count);
+    std::size_t allocation_budget() const;
+};
@@ -2,44 +2,166 @@
 
 
 #include <memory_resource>
+#include <atomic>
 #include <memory>
 #include <iterator>
 #include <stdexcept>
 #include <initializer_list>
 #include <utility>
+#include <type_traits>
 #include <iostream>
+#include <cstdint>
+#include <new>
 
-template<typename T>
+#include "background_reclaimer.h"
+#include "bulk_memory_resource.h"
+#include "dynamic_array_policies.h"
+#include "latency_histogram.h"
+
+// Признак наличия у T метода reassign(args...) - повторной инициализации
+// объекта в уже выделенной памяти; им пользуется пул удалённых элементов
+// DynamicArray (set_recycling)
+template<typename Void, typename T, typename... Args>
+struct has_reassign_impl : std::false_type {};
+
+template<typename T, typename... Args>
+struct has_reassign_impl<std::void_t<decltype(std::declval<T&>().reassign(std::declval<Args>()...))>,
+                         T, Args...> : std::true_type {};
+
+template<typename T, typename... Args>
+inline constexpr bool has_reassign_v = has_reassign_impl<void, T, Args...>::value;
+
+// Результат DynamicArray::compact(). Локальность оценивается средним
+// расстоянием в байтах между адресами соседних (в порядке обхода) элементов.
+struct CompactionReport {
+    size_t elements = 0;
+    double mean_gap_before = 0.0;
+    double mean_gap_after = 0.0;
+    
+    // Во сколько раз сократилось среднее расстояние между соседями
+    double locality_gain() const {
+        return mean_gap_after > 0.0 ? mean_gap_before / mean_gap_after : 1.0;
+    }
+};
+
+// Policies - политики из dynamic_array_policies.h (выделение памяти, рост,
+// размещение, проверка границ); по умолчанию массив работает через
+// std::pmr::polymorphic_allocator
+template<typename T, typename... Policies>
 class DynamicArray {
+    static_assert(valid_policies_v<Policies...>,
+                  "unknown DynamicArray policy or policy category given more than once");
+    
+    using Allocation = select_policy_t<allocation_policy_tag, PmrAllocation, Policies...>;
+    using Growth = select_policy_t<growth_policy_tag, BatchGrowth<1024>, Policies...>;
+    using Layout = select_policy_t<layout_policy_tag, PackedLayout, Policies...>;
+    using Bounds = select_policy_t<bounds_policy_tag, CheckedAccess, Policies...>;
+    
+public:
+    using value_type = T;
+    using allocator_type = typename Allocation::template allocator<T>;
+    
 private:
+    using slot_type = typename Layout::template slot_type<T>;
+    using slot_allocator_type =
+        typename std::allocator_traits<allocator_type>::template rebind_alloc<slot_type>;
+    
+    struct Slab;
+    
     struct Node {
         T* data;
         Node* next;
+        Slab* slab;   // плотный блок compact(), где лежат узел и элемент; &paired_entry - узел и элемент
+                      // в одном блоке ресурса; nullptr - отдельные аллокации
         
-        Node(T* d, Node* n = nullptr) : data(d), next(n) {}
+        Node(T* d, Node* n = nullptr, Slab* s = nullptr) : data(d), next(n), slab(s) {}
     };
     
-    Node* head_;
+    // Плотный блок, создаваемый compact(): заголовок Slab, затем записи
+    // "узел + элемент" в порядке обхода. Блок освобождается целиком, когда
+    // уничтожен последний его элемент; live атомарен, так как элементы одного
+    // блока могут уничтожаться разными массивами (после splice) и фоновым потоком.
+    struct CompactEntry {
+        alignas(Node) unsigned char node[sizeof(Node)];
+        alignas(slot_type) unsigned char slot[sizeof(slot_type)];
+    };
+    
+    struct Slab {
+        std::atomic<size_t> live;
+        size_t capacity;
+        
+        explicit Slab(size_t count) : live(count), capacity(count) {}
+    };
+    
+    // Метка узлов, выделенных пакетом вместе с элементом: каждая запись
+    // CompactEntry - отдельный блок allocate_bulk, и узел освобождается
+    // вместе с элементом одним вызовом. Сам объект не используется.
+    static inline Slab paired_entry{0};
+    
+    static constexpr bool nodes_use_allocator = !std::is_same_v<Allocation, PmrAllocation>;
+    using node_allocator_type =
+        typename std::allocator_traits<allocator_type>::template rebind_alloc<Node>;
+    using entry_allocator_type =
+        typename std::allocator_traits<allocator_type>::template rebind_alloc<CompactEntry>;
+    static constexpr size_t slab_header_entries =
+        (sizeof(Slab) + sizeof(CompactEntry) - 1) / sizeof(CompactEntry);
+    
+    // Сколько блоков запрашивается у BulkMemoryResource за один вызов
+    static constexpr size_t bulk_batch_size = Growth::bulk_batch_size;
+    
+    // persist_array() и restore_array() (persistent_array.h) передают
+    // цепочку узлов файлу и забирают её обратно целиком
+    friend struct PersistentArrayAccess;
+    
+    // Узел-маркер перед первым элементом: before_head_.next - голова списка,
+    // &before_head_ - позиция before_begin(); mutable, чтобы const-массив мог
+    // выдать на него const_iterator
+    mutable Node before_head_;
     Node* tail_;
     size_t size_;
-    std::pmr::polymorphic_allocator<T> allocator_;
+    allocator_type allocator_;
+    BackgroundReclaimer* reclaimer_;
     
-public:
-    using value_type = T;
-    using allocator_type = std::pmr::polymorphic_allocator<T>;
+    // Режим copy-on-write: копии такого массива разделяют цепочку узлов.
+    // share_count_ - счётчик владельцев разделяемой цепочки (nullptr, если
+    // цепочка принадлежит только этому массиву); mutable и атомарен, потому
+    // что копирование из const-массива делает его цепочку разделяемой, а
+    // const-массив могут одновременно копировать несколько потоков.
+    bool copy_on_write_;
+    mutable std::atomic<std::atomic<size_t>*> share_count_;
+    
+    // Пул удалённых, но не уничтоженных элементов вместе с их узлами
+    // (связаны через next); pool_limit_ == 0 - режим выключен
+    Node* pool_head_;
+    size_t pool_size_;
+    size_t pool_limit_;
+    
+#ifdef LAB5_LATENCY_HISTOGRAMS
+    LazyLatencyStats<DynamicArrayLatency> latency_;
+#endif
     
-    class Iterator {
+public:
+    // Итератор; IsConst = true даёт const_iterator, который выдаёт только const T&
+    template<bool IsConst>
+    class BasicIterator {
     private:
         Node* current_;
         
+        template<bool> friend class BasicIterator;
+        friend class DynamicArray;
+        
     public:
         using iterator_category = std::forward_iterator_tag;
         using value_type = T;
         using difference_type = std::ptrdiff_t;
-        using pointer = T*;
-        using reference = T&;
+        using pointer = std::conditional_t<IsConst, const T*, T*>;
+        using reference = std::conditional_t<IsConst, const T&, T&>;
         
-        explicit Iterator(Node* node = nullptr) : current_(node) {}
+        explicit BasicIterator(Node* node = nullptr) : current_(node) {}
+        
+        // iterator неявно преобразуется в const_iterator, но не наоборот
+        template<bool OtherConst, typename = std::enable_if_t<IsConst && !OtherConst>>
+        BasicIterator(const BasicIterator<OtherConst>& other) : current_(other.current_) {}
         
         reference operator*() const {
             return *(current_->data);
@@ -49,56 +171,80 @@ public:
             return current_->data;
         }
         
-        Iterator& operator++() {
+        BasicIterator& operator++() {
             current_ = current_->next;
             return *this;
         }
         
-        Iterator operator++(int) {
-            Iterator temp = *this;
+        BasicIterator operator++(int) {
+            BasicIterator temp = *this;
             ++(*this);
             return temp;
         }
         
-        bool operator==(const Iterator& other) const {
+        template<bool OtherConst>
+        bool operator==(const BasicIterator<OtherConst>& other) const {
             return current_ == other.current_;
         }
         
-        bool operator!=(const Iterator& other) const {
+        template<bool OtherConst>
+        bool operator!=(const BasicIterator<OtherConst>& other) const {
             return !(*this == other);
         }
     };
     
-    using iterator = Iterator;
-    using const_iterator = const Iterator;
+    using iterator = BasicIterator<false>;
+    using const_iterator = BasicIterator<true>;
     
     // Конструкторы
-    explicit DynamicArray(std::pmr::polymorphic_allocator<T> alloc = {})
-        : head_(nullptr), tail_(nullptr), size_(0), allocator_(alloc) {}
+    explicit DynamicArray(allocator_type alloc = {})
+        : before_head_(nullptr), tail_(nullptr), size_(0), allocator_(alloc), reclaimer_(nullptr),
+          copy_on_write_(false), share_count_(nullptr),
+          pool_head_(nullptr), pool_size_(0), pool_limit_(0) {}
     
     DynamicArray(std::initializer_list<T> init, 
-                std::pmr::polymorphic_allocator<T> alloc = {})
-        : head_(nullptr), tail_(nullptr), size_(0), allocator_(alloc) {
-        for (const auto& item : init) {
-            push_back(item);
-        }
+                allocator_type alloc = {})
+        : before_head_(nullptr), tail_(nullptr), size_(0), allocator_(alloc), reclaimer_(nullptr),
+          copy_on_write_(false), share_count_(nullptr),
+          pool_head_(nullptr), pool_size_(0), pool_limit_(0) {
+        append_range(init.begin(), init.end());
     }
     
-    // Конструктор копирования
+    // Конструктор из диапазона итераторов
+    template<typename InputIt,
+             typename = typename std::iterator_traits<InputIt>::iterator_category>
+    DynamicArray(InputIt first, InputIt last, allocator_type alloc = {})
+        : before_head_(nullptr), tail_(nullptr), size_(0), allocator_(alloc), reclaimer_(nullptr),
+          copy_on_write_(false), share_count_(nullptr),
+          pool_head_(nullptr), pool_size_(0), pool_limit_(0) {
+        append_range(first, last);
+    }
+    
+    // Конструктор копирования; в режиме copy-on-write копия за O(1)
+    // разделяет цепочку узлов с other
     DynamicArray(const DynamicArray& other) 
-        : head_(nullptr), tail_(nullptr), size_(0), 
-          allocator_(other.allocator_) {
-        for (const auto& item : other) {
-            push_back(item);
+        : before_head_(nullptr), tail_(nullptr), size_(0), 
+          allocator_(other.allocator_), reclaimer_(other.reclaimer_),
+          copy_on_write_(other.copy_on_write_), share_count_(nullptr),
+          pool_head_(nullptr), pool_size_(0), pool_limit_(other.pool_limit_) {
+        LAB5_MEASURE_LATENCY(latency_.record(&DynamicArrayLatency::copy));
+        if (copy_on_write_) {
+            share_from(other);
+        } else {
+            copy_from(other);
         }
     }
     
-    // Оператор присваивания
+    // Оператор присваивания; цепочка разделяется, только если у other
+    // включён copy-on-write и ресурсы совпадают
     DynamicArray& operator=(const DynamicArray& other) {
         if (this != &other) {
+            LAB5_MEASURE_LATENCY(latency_.record(&DynamicArrayLatency::copy));
             clear();
-            for (const auto& item : other) {
-                push_back(item);
+            if (other.copy_on_write_ && allocator_ == other.allocator_) {
+                share_from(other);
+            } else {
+                copy_from(other);
             }
         }
         return *this;
@@ -106,86 +252,88 @@ public:
     
     // Конструктор перемещения
     DynamicArray(DynamicArray&& other) noexcept
-        : head_(other.head_), tail_(other.tail_), 
-          size_(other.size_), allocator_(std::move(other.allocator_)) {  // Используем перемещение
-        other.head_ = nullptr;
+        : before_head_(nullptr, other.before_head_.next), tail_(other.tail_), 
+          size_(other.size_), allocator_(std::move(other.allocator_)),  // Используем перемещение
+          reclaimer_(other.reclaimer_), copy_on_write_(other.copy_on_write_),
+          share_count_(other.share_count_.load(std::memory_order_relaxed)),
+          pool_head_(nullptr), pool_size_(0), pool_limit_(other.pool_limit_) {
+#ifdef LAB5_LATENCY_HISTOGRAMS
+        // Гистограммы переходят к новому массиву вместе с содержимым
+        latency_.swap(other.latency_);
+#endif
+        LAB5_MEASURE_LATENCY(latency_.record_if_allocated(&DynamicArrayLatency::move));
+        other.before_head_.next = nullptr;
         other.tail_ = nullptr;
         other.size_ = 0;
+        other.share_count_.store(nullptr, std::memory_order_relaxed);
     }
     
     // Оператор перемещения
     DynamicArray& operator=(DynamicArray&& other) noexcept {
         if (this != &other) {
-            clear();
-            head_ = other.head_;
+            LAB5_MEASURE_LATENCY(latency_.record_if_allocated(&DynamicArrayLatency::move));
+            release_nodes();
+            before_head_.next = other.before_head_.next;
             tail_ = other.tail_;
             size_ = other.size_;
+            share_count_.store(other.share_count_.load(std::memory_order_relaxed),
+                               std::memory_order_relaxed);
             // Аллокатор не присваиваем - сохраняем текущий
             // Или перемещаем, если поддерживается
             
-            other.head_ = nullptr;
+            other.before_head_.next = nullptr;
             other.tail_ = nullptr;
             other.size_ = 0;
+            other.share_count_.store(nullptr, std::memory_order_relaxed);
         }
         return *this;
     }
     
     // Деструктор
     ~DynamicArray() {
-        clear();
+        LAB5_MEASURE_LATENCY(latency_.record_if_allocated(&DynamicArrayLatency::clear));
+        pool_limit_ = 0;
+        release_nodes();
+        release_pool();
     }
     
     // Методы контейнера
     void push_back(const T& value) {
-        T* new_data = allocator_.allocate(1);
-        std::allocator_traits<std::pmr::polymorphic_allocator<T>>::construct(allocator_, new_data, value);
-        
-        Node* new_node = new Node(new_data);
-        
-        if (empty()) {
-            head_ = tail_ = new_node;
-        } else {
-            tail_->next = new_node;
-            tail_ = new_node;
-        }
-        size_++;
+        LAB5_MEASURE_LATENCY(latency_.record(&DynamicArrayLatency::push_back));
+        detach();
+        link_back(create_node(value));
     }
     
     void push_back(T&& value) {
-        T* new_data = allocator_.allocate(1);
-        std::allocator_traits<std::pmr::polymorphic_allocator<T>>::construct(
-            allocator_, new_data, std::move(value));
-        
-        Node* new_node = new Node(new_data);
-        
-        if (empty()) {
-            head_ = tail_ = new_node;
-        } else {
-            tail_->next = new_node;
-            tail_ = new_node;
-        }
-        size_++;
+        LAB5_MEASURE_LATENCY(latency_.record(&DynamicArrayLatency::push_back));
+        detach();
+        link_back(create_node(std::move(value)));
+    }
+    
+    // Создаёт элемент прямо в памяти контейнера, без временного объекта
+    template<typename... Args>
+    T& emplace_back(Args&&... args) {
+        LAB5_MEASURE_LATENCY(latency_.record(&DynamicArrayLatency::push_back));
+        detach();
+        link_back(create_node(std::forward<Args>(args)...));
+        return *(tail_->data);
     }
     
     void pop_back() {
-        if (empty()) {
-            throw std::out_of_range("DynamicArray is empty");
-        }
+        LAB5_MEASURE_LATENCY(latency_.record(&DynamicArrayLatency::pop_back));
+        Bounds::check(!empty(), "DynamicArray is empty");
+        detach();
         
-        if (head_ == tail_) {
-            std::allocator_traits<std::pmr::polymorphic_allocator<T>>::destroy(allocator_, tail_->data);
-            allocator_.deallocate(tail_->data, 1);
-            delete tail_;
-            head_ = tail_ = nullptr;
+        if (before_head_.next == tail_) {
+            destroy_node(tail_);
+            before_head_.next = tail_ = nullptr;
         } else {
-            Node* current = head_;
+            Node* current = before_head_.next;
             while (current->next != tail_) {
                 current = current->next;
             }
             
-            std::allocator_traits<std::pmr::polymorphic_allocator<T>>::destroy(allocator_, tail_->data);
-            allocator_.deallocate(tail_->data, 1);
-            delete tail_;
+            destroy_node(tail_);
             
             tail_ = current;
             tail_->next = nullptr;
@@ -194,34 +342,241 @@ public:
     }
     
     T& front() {
-        if (empty()) {
-            throw std::out_of_range("DynamicArray is empty");
-        }
-        return *(head_->data);
+        Bounds::check(!empty(), "DynamicArray is empty");
+        detach();
+        return *(before_head_.next->data);
     }
     
     const T& front() const {
-        if (empty()) {
-            throw std::out_of_range("DynamicArray is empty");
-        }
-        return *(head_->data);
+        Bounds::check(!empty(), "DynamicArray is empty");
+        return *(before_head_.next->data);
     }
     
     T& back() {
-        if (empty()) {
-            throw std::out_of_range("DynamicArray is empty");
-        }
+        Bounds::check(!empty(), "DynamicArray is empty");
+        detach();
         return *(tail_->data);
     }
     
     const T& back() const {
+        Bounds::check(!empty(), "DynamicArray is empty");
+        return *(tail_->data);
+    }
+    
+    // ==================== Операции в начале и середине, O(1) ====================
+    
+    void push_front(const T& value) {
+        detach();
+        link_after(&before_head_, create_node(value));
+    }
+    
+    void push_front(T&& value) {
+        detach();
+        link_after(&before_head_, create_node(std::move(value)));
+    }
+    
+    template<typename... Args>
+    T& emplace_front(Args&&... args) {
+        detach();
+        return *link_after(&before_head_, create_node(std::forward<Args>(args)...))->data;
+    }
+    
+    void pop_front() {
+        Bounds::check(!empty(), "DynamicArray is empty");
+        detach();
+        erase_after_node(&before_head_);
+    }
+    
+    // Позиция перед первым элементом для insert_after/erase_after/splice_after
+    iterator before_begin() {
+        detach();
+        return iterator(&before_head_);
+    }
+    
+    const_iterator before_begin() const {
+        return const_iterator(&before_head_);
+    }
+    
+    const_iterator cbefore_begin() const {
+        return before_begin();
+    }
+    
+    // Вставляет элемент после position и возвращает итератор на него
+    iterator insert_after(const_iterator position, const T& value) {
+        return emplace_after(position, value);
+    }
+    
+    iterator insert_after(const_iterator position, T&& value) {
+        return emplace_after(position, std::move(value));
+    }
+    
+    // Вставляет копии [first, last) после position; возвращает итератор на
+    // последний вставленный элемент (position, если диапазон пуст)
+    template<typename InputIt,
+             typename = typename std::iterator_traits<InputIt>::iterator_category>
+    iterator insert_after(const_iterator position, InputIt first, InputIt last) {
+        Node* node = checked_position(position);
+        DynamicArray inserted(allocator_);
+        // Вставляемые элементы сначала занимают узлы пула этого массива
+        std::swap(inserted.pool_head_, pool_head_);
+        std::swap(inserted.pool_size_, pool_size_);
+        try {
+            inserted.append_range(first, last);
+        } catch (...) {
+            std::swap(inserted.pool_head_, pool_head_);
+            std::swap(inserted.pool_size_, pool_size_);
+            throw;
+        }
+        std::swap(inserted.pool_head_, pool_head_);
+        std::swap(inserted.pool_size_, pool_size_);
+        if (inserted.empty()) {
+            return iterator(node);
+        }
+        detach({&node});
+        Node* last_inserted = inserted.tail_;
+        transfer_after(node, inserted, &inserted.before_head_, inserted.tail_, inserted.size_);
+        return iterator(last_inserted);
+    }
+    
+    template<typename... Args>
+    iterator emplace_after(const_iterator position, Args&&... args) {
+        Node* node = checked_position(position);
+        detach({&node});
+        return iterator(link_after(node, create_node(std::forward<Args>(args)...)));
+    }
+    
+    // Удаляет элемент после position и возвращает итератор на следующий
+    iterator erase_after(const_iterator position) {
+        Node* node = checked_position(position);
+        detach({&node});
+        erase_after_node(node);
+        return iterator(node->next);
+    }
+    
+    // Переносит все элементы other после position. Если ресурсы массивов
+    // равны, узлы перевешиваются за O(1) без копирования элементов, иначе
+    // элементы перемещаются в память этого массива за O(other.size()).
+    void splice_after(const_iterator position, DynamicArray& other) {
+        if (&other == this) {
+            throw std::invalid_argument("Cannot splice DynamicArray into itself");
+        }
+        Node* node = checked_position(position);
+        if (other.empty()) {
+            return;
+        }
+        detach({&node});
+        other.detach();
+        transfer_after(node, other, &other.before_head_, other.tail_, other.size_);
+    }
+    
+    // Переносит из other один элемент, следующий за it; O(1) при равных ресурсах
+    void splice_after(const_iterator position, DynamicArray& other, const_iterator it) {
+        Node* node = checked_position(position);
+        Node* first = other.checked_position(it);
+        if (&other == this) {
+            // Обе позиции должны указать в одну и ту же отделённую копию
+            detach({&node, &first});
+        } else {
+            detach({&node});
+            other.detach({&first});
+        }
+        Node* element = first->next;
+        if (element == nullptr || element == node) {
+            return;
+        }
+        if (&other == this && first == node) {
+            return;
+        }
+        transfer_after(node, other, first, element, 1);
+    }
+    
+    // Переносит из other элементы в интервале (first, last). Перевешивание
+    // узлов не копирует элементы, но для обновления размеров интервал
+    // проходится один раз: O(длина интервала).
+    void splice_after(const_iterator position, DynamicArray& other,
+                      const_iterator first, const_iterator last) {
+        if (&other == this) {
+            throw std::invalid_argument("Cannot splice a range within the same DynamicArray");
+        }
+        Node* node = checked_position(position);
+        Node* first_node = other.checked_position(first);
+        Node* last_node = last.current_;
+        detach({&node});
+        other.detach({&first_node, &last_node});
+        
+        Node* range_last = first_node;
+        size_t count = 0;
+        for (Node* current = first_node->next; current != last_node;
+             current = current->next) {
+            range_last = current;
+            count++;
+        }
+        transfer_after(node, other, first_node, range_last, count);
+    }
+    
+    // ==================== Компактизация ====================
+    
+    // Перемещает элементы (move, либо copy, если перемещение может бросить
+    // исключение) в один плотный блок в порядке обхода и освобождает прежние
+    // аллокации. Узел и элемент лежат в блоке рядом, поэтому обход после
+    // компактизации идёт по памяти последовательно. Итераторы и ссылки
+    // становятся недействительными. При исключении массив не меняется.
+    CompactionReport compact() {
+        CompactionReport report;
+        report.elements = size_;
+        report.mean_gap_before = mean_gap();
         if (empty()) {
-            throw std::out_of_range("DynamicArray is empty");
+            return report;
         }
-        return *(tail_->data);
+        detach();
+        
+        entry_allocator_type entry_alloc(allocator_);
+        CompactEntry* entries = entry_alloc.allocate(slab_header_entries + size_);
+        Slab* slab = new (static_cast<void*>(entries)) Slab(size_);
+        CompactEntry* entry = entries + slab_header_entries;
+        
+        Node* new_head = nullptr;
+        Node* new_tail = nullptr;
+        try {
+            for (Node* current = before_head_.next; current != nullptr; current = current->next) {
+                T* data = reinterpret_cast<T*>(entry->slot);
+                std::allocator_traits<allocator_type>::construct(
+                    allocator_, data, std::move_if_noexcept(*current->data));
+                Node* node = new (static_cast<void*>(entry->node)) Node(data, nullptr, slab);
+                if (new_tail == nullptr) {
+                    new_head = node;
+                } else {
+                    new_tail->next = node;
+                }
+                new_tail = node;
+                ++entry;
+            }
+        } catch (...) {
+            while (new_head != nullptr) {
+                Node* next = new_head->next;
+                std::allocator_traits<allocator_type>::destroy(allocator_, new_head->data);
+                new_head->~Node();
+                new_head = next;
+            }
+            free_slab(allocator_, slab);
+            throw;
+        }
+        
+        destroy_chain(allocator_, before_head_.next);
+        before_head_.next = new_head;
+        tail_ = new_tail;
+        report.mean_gap_after = mean_gap();
+        return report;
+    }
+    
+    // Плотно переупаковывает элементы и освобождает пул повторного использования
+    void shrink_to_fit() {
+        release_pool();
+        compact();
     }
     
     bool empty() const {
+
         return size_ == 0;
     }
     
@@ -229,15 +584,20 @@ public:
         return size_;
     }
     
+    // Освобождает узлы за один проход от головы; pop_back в цикле
+    // давал бы O(n^2) из-за поиска предпоследнего узла.
+    // Если задан фоновый поток освобождения, цепочка узлов отсоединяется
+    // и уничтожается им, а вызывающий поток тратит O(1).
     void clear() {
-        while (!empty()) {
-            pop_back();
-        }
+        LAB5_MEASURE_LATENCY(latency_.record(&DynamicArrayLatency::clear));
+        release_nodes();
     }
     
-    // Итераторы
+    // Итераторы. Неконстантный begin() отделяет разделяемую цепочку,
+    // поэтому для чтения copy-on-write массива лучше использовать cbegin()
     iterator begin() {
-        return iterator(head_);
+        detach();
+        return iterator(before_head_.next);
     }
     
     iterator end() {
@@ -245,23 +605,572 @@ public:
     }
     
     const_iterator begin() const {
-        return iterator(head_);
+        return const_iterator(before_head_.next);
     }
     
     const_iterator end() const {
-        return iterator(nullptr);
+        return const_iterator(nullptr);
     }
     
     const_iterator cbegin() const {
-        return iterator(head_);
+        return const_iterator(before_head_.next);
     }
     
     const_iterator cend() const {
-        return iterator(nullptr);
+        return const_iterator(nullptr);
     }
     
     // Получение аллокатора
     allocator_type get_allocator() const {
         return allocator_;
     }
+    
+    // Включает отложенное уничтожение: clear(), деструктор и присваивания
+    // передают элементы в фоновый поток reclaimer. nullptr выключает режим.
+    // reclaimer и memory_resource контейнера должны пережить все задания.
+    void set_reclaimer(BackgroundReclaimer* reclaimer) {
+        reclaimer_ = reclaimer;
+    }
+    
+    BackgroundReclaimer* reclaimer() const {
+        return reclaimer_;
+    }
+    
+    // Включает copy-on-write: копии этого массива разделяют хранилище со
+    // счётчиком ссылок и копируют элементы только при первом изменении
+    // (push_back, emplace_back, pop_back, неконстантные begin/front/back).
+    // Ссылки и итераторы, полученные до копирования, продолжают указывать
+    // в разделяемое хранилище.
+    void set_copy_on_write(bool enabled) {
+        copy_on_write_ = enabled;
+    }
+    
+    bool copy_on_write() const {
+        return copy_on_write_;
+    }
+    
+    // Разделяет ли массив хранилище с другими копиями
+    bool is_shared() const {
+        std::atomic<size_t>* owners = share_count_.load(std::memory_order_acquire);
+        return owners != nullptr && owners->load(std::memory_order_acquire) > 1;
+    }
+    
+    // Включает пул повторного использования: удалённые элементы (pop_back,
+    // pop_front, erase_after, clear) не уничтожаются, а вместе с узлом
+    // остаются в пуле (не более max_pooled), и следующее создание элемента
+    // берёт их оттуда. Если у T есть reassign(args...), поля записываются в
+    // уже выделенную память элемента (строки, векторы); для копии или
+    // перемещения того же типа используется присваивание; иначе элемент
+    // пересоздаётся на месте. 0 выключает режим и освобождает пул.
+    void set_recycling(size_t max_pooled) {
+        pool_limit_ = max_pooled;
+        while (pool_size_ > pool_limit_) {
+            Node* node = pool_head_;
+            pool_head_ = node->next;
+            pool_size_--;
+            destroy_node(allocator_, node);
+        }
+    }
+    
+    size_t recycling_limit() const {
+        return pool_limit_;
+    }
+    
+    // Число элементов, ожидающих повторного использования
+    size_t pooled() const {
+        return pool_size_;
+    }
+    
+    // Уничтожает все элементы пула; режим остаётся включённым
+    void release_pool() {
+        destroy_chain(allocator_, pool_head_);
+        pool_size_ = 0;
+    }
+    
+#ifdef LAB5_LATENCY_HISTOGRAMS
+    // Гистограммы задержек операций этого контейнера
+    const DynamicArrayLatency& latency_stats() const {
+        return latency_.get();
+    }
+    
+    void reset_latency_stats() {
+        latency_.reset();
+    }
+#endif
+    
+private:
+    // Выделяет место под элемент согласно политике Layout и создаёт в нём
+    // элемент; в режиме пула сначала берёт готовый узел из пула
+    template<typename... Args>
+    Node* create_node(Args&&... args) {
+        if (pool_head_ != nullptr) {
+            return reuse_node(std::forward<Args>(args)...);
+        }
+        slot_allocator_type slot_alloc(allocator_);
+        slot_type* slot = slot_alloc.allocate(1);
+        T* new_data = reinterpret_cast<T*>(slot);
+        try {
+            std::allocator_traits<allocator_type>::construct(
+                allocator_, new_data, std::forward<Args>(args)...);
+        } catch (...) {
+            slot_alloc.deallocate(slot, 1);
+            throw;
+        }
+        try {
+            return new_node(allocator_, new_data);
+        } catch (...) {
+            std::allocator_traits<allocator_type>::destroy(allocator_, new_data);
+            slot_alloc.deallocate(slot, 1);
+            throw;
+        }
+    }
+    
+    // Узел отдельного элемента. С PmrAllocation узлы, как и прежде, берутся
+    // из operator new, и учёт блоков ресурса видит только элементы; с
+    // остальными политиками узлы выделяются тем же аллокатором, что и
+    // элементы, и вызовы тоже встраиваются
+    static Node* new_node(allocator_type& allocator, T* data) {
+        if constexpr (nodes_use_allocator) {
+            node_allocator_type node_alloc(allocator);
+            Node* node = node_alloc.allocate(1);
+            return new (static_cast<void*>(node)) Node(data);
+        } else {
+            (void)allocator;
+            return new Node(data);
+        }
+    }
+    
+    static void delete_node(allocator_type& allocator, Node* node) {
+        if constexpr (nodes_use_allocator) {
+            node->~Node();
+            node_allocator_type(allocator).deallocate(node, 1);
+        } else {
+            (void)allocator;
+            delete node;
+        }
+    }
+    
+    // Берёт узел из пула и записывает в его элемент новое значение
+    template<typename... Args>
+    Node* reuse_node(Args&&... args) {
+        Node* node = pool_head_;
+        pool_head_ = node->next;
+        pool_size_--;
+        node->next = nullptr;
+        
+        if constexpr (has_reassign_v<T, Args&&...> ||
+                      (sizeof...(Args) == 1 && (std::is_same_v<std::decay_t<Args>, T> && ...))) {
+            try {
+                if constexpr (has_reassign_v<T, Args&&...>) {
+                    node->data->reassign(std::forward<Args>(args)...);
+                } else {
+                    (*node->data = ... = std::forward<Args>(args));
+                }
+            } catch (...) {
+                destroy_node(allocator_, node);
+                throw;
+            }
+        } else {
+            std::allocator_traits<allocator_type>::destroy(allocator_, node->data);
+            try {
+                std::allocator_traits<allocator_type>::construct(
+                    allocator_, node->data, std::forward<Args>(args)...);
+            } catch (...) {
+                free_node_storage(allocator_, node);
+                throw;
+            }
+        }
+        return node;
+    }
+    
+    // Кладёт удалённый узел в пул, не уничтожая элемент
+    void recycle_node(Node* node) {
+        node->next = pool_head_;
+        pool_head_ = node;
+        pool_size_++;
+    }
+    
+    // Уничтожает элемент, возвращает его память ресурсу и удаляет узел
+    static void destroy_node(allocator_type& allocator, Node* node) {
+        std::allocator_traits<allocator_type>::destroy(allocator, node->data);
+        free_node_storage(allocator, node);
+    }
+    
+    // Освобождает память узла и уже уничтоженного элемента
+    static void free_node_storage(allocator_type& allocator, Node* node) {
+        if (node->slab == nullptr) {
+            slot_allocator_type(allocator).deallocate(reinterpret_cast<slot_type*>(node->data), 1);
+            delete_node(allocator, node);
+            return;
+        }
+        if (node->slab == &paired_entry) {
+            // Узел - первое поле записи, его адрес совпадает с адресом блока
+            node->~Node();
+            entry_allocator_type(allocator).deallocate(reinterpret_cast<CompactEntry*>(node), 1);
+            return;
+        }
+        Slab* slab = node->slab;
+        node->~Node();
+        if (slab->live.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            free_slab(allocator, slab);
+        }
+    }
+    
+    static void free_slab(allocator_type& allocator, Slab* slab) {
+        size_t capacity = slab->capacity;
+        slab->~Slab();
+        entry_allocator_type(allocator).deallocate(
+            reinterpret_cast<CompactEntry*>(slab), slab_header_entries + capacity);
+    }
+    
+    // Среднее расстояние в байтах между адресами соседних элементов
+    double mean_gap() const {
+        if (size_ < 2) {
+            return 0.0;
+        }
+        double total = 0.0;
+        for (Node* current = before_head_.next; current->next != nullptr; current = current->next) {
+            auto here = reinterpret_cast<std::uintptr_t>(current->data);
+            auto next = reinterpret_cast<std::uintptr_t>(current->next->data);
+            total += static_cast<double>(here > next ? here - next : next - here);
+        }
+        return total / static_cast<double>(size_ - 1);
+    }
+    
+    void destroy_node(Node* node) {
+        if (pool_size_ < pool_limit_) {
+            recycle_node(node);
+            return;
+        }
+        destroy_node(allocator_, node);
+    }
+    
+    // Пакетный интерфейс ресурса или nullptr: пакеты доступны только через
+    // polymorphic_allocator и только при политике роста с пакетами больше 1
+    static BulkMemoryResource* bulk_resource(const allocator_type& allocator) {
+        if constexpr (std::is_same_v<allocator_type, std::pmr::polymorphic_allocator<T>> &&
+                      bulk_batch_size > 1) {
+            return as_bulk_resource(allocator.resource());
+        } else {
+            (void)allocator;
+            return nullptr;
+        }
+    }
+    
+    // Уничтожает не более max_nodes узлов цепочки, начиная с head;
+    // head сдвигается на первый неуничтоженный узел. Ресурсу с пакетным
+    // интерфейсом память элементов и пакетных записей возвращается пачками
+    // deallocate_bulk.
+    static void destroy_chain(allocator_type& allocator, Node*& head,
+                              size_t max_nodes = static_cast<size_t>(-1)) {
+        BulkMemoryResource* bulk = head != nullptr ? bulk_resource(allocator) : nullptr;
+        if (bulk == nullptr) {
+            while (head != nullptr && max_nodes-- > 0) {
+                Node* next = head->next;
+                destroy_node(allocator, head);
+                head = next;
+            }
+            return;
+        }
+        
+        void* slots[bulk_batch_size];
+        void* entries[bulk_batch_size];
+        size_t pending = 0;
+        size_t pending_entries = 0;
+        while (head != nullptr && max_nodes-- > 0) {
+            Node* next = head->next;
+            if (head->slab == &paired_entry) {
+                std::allocator_traits<allocator_type>::destroy(allocator, head->data);
+                head->~Node();
+                entries[pending_entries++] = head;
+                if (pending_entries == bulk_batch_size) {
+                    bulk->deallocate_bulk(pending_entries, sizeof(CompactEntry),
+                                          alignof(CompactEntry), entries);
+                    pending_entries = 0;
+                }
+            } else if (head->slab != nullptr) {
+                destroy_node(allocator, head);
+            } else {
+                std::allocator_traits<allocator_type>::destroy(allocator, head->data);
+                slots[pending++] = head->data;
+                delete_node(allocator, head);
+                if (pending == bulk_batch_size) {
+                    bulk->deallocate_bulk(pending, sizeof(slot_type), alignof(slot_type), slots);
+                    pending = 0;
+                }
+            }
+            head = next;
+        }
+        if (pending > 0) {
+            bulk->deallocate_bulk(pending, sizeof(slot_type), alignof(slot_type), slots);
+        }
+        if (pending_entries > 0) {
+            bulk->deallocate_bulk(pending_entries, sizeof(CompactEntry), alignof(CompactEntry),
+                                  entries);
+        }
+    }
+    
+    // Отсоединённая цепочка узлов, уничтожаемая фоновым потоком порциями
+    class DetachedChain : public ReclaimJob {
+    private:
+        Node* head_;
+        allocator_type allocator_;
+        
+    public:
+        DetachedChain(Node* head, const allocator_type& allocator)
+            : head_(head), allocator_(allocator) {}
+        
+        ~DetachedChain() override {
+            destroy_chain(allocator_, head_);
+        }
+        
+        bool run(std::size_t max_items) override {
+            destroy_chain(allocator_, head_, max_items);
+            return head_ == nullptr;
+        }
+    };
+    
+    // Поэлементное копирование other в конец массива
+    void copy_from(const DynamicArray& other) {
+        append_range(other.cbegin(), other.cend());
+    }
+    
+    // Добавляет копии [first, last) в конец. Сначала используются узлы пула;
+    // если ресурс поддерживает пакетное выделение (BulkMemoryResource),
+    // остальные элементы берутся пачками по bulk_batch_size записей
+    // "узел + элемент" одним вызовом allocate_bulk, так что копия не
+    // обращается к operator new за узлами; для однопроходных итераторов и
+    // прочих ресурсов - поэлементно.
+    template<typename InputIt>
+    void append_range(InputIt first, InputIt last) {
+        detach();
+        using category = typename std::iterator_traits<InputIt>::iterator_category;
+        BulkMemoryResource* bulk = nullptr;
+        if constexpr (std::is_base_of_v<std::forward_iterator_tag, category>) {
+            bulk = bulk_resource(allocator_);
+        }
+        if (bulk == nullptr) {
+            for (; first != last; ++first) {
+                link_back(create_node(*first));
+            }
+            return;
+        }
+        for (; first != last && pool_head_ != nullptr; ++first) {
+            link_back(reuse_node(*first));
+        }
+        
+
+        void* entries[bulk_batch_size];
+        while (first != last) {
+            size_t count = 0;
+            for (InputIt it = first; it != last && count < bulk_batch_size; ++it) {
+                count++;
+            }
+            bulk->allocate_bulk(count, sizeof(CompactEntry), alignof(CompactEntry), entries);
+            size_t built = 0;
+            try {
+                for (; built < count; ++built, ++first) {
+                    auto* entry = static_cast<CompactEntry*>(entries[built]);
+                    T* data = reinterpret_cast<T*>(entry->slot);
+                    std::allocator_traits<allocator_type>::construct(allocator_, data, *first);
+                    link_back(new (static_cast<void*>(entry->node)) Node(data, nullptr, &paired_entry));
+                }
+            } catch (...) {
+                // Уже созданные элементы принадлежат массиву, остальные блоки возвращаются
+                bulk->deallocate_bulk(count - built, sizeof(CompactEntry), alignof(CompactEntry),
+                                      entries + built);
+                throw;
+            }
+        }
+
+    }
+    
+    // Делает цепочку other разделяемой и подключается к ней; массив пуст
+    void share_from(const DynamicArray& other) {
+        if (other.before_head_.next == nullptr) {
+            return;
+        }
+        std::atomic<size_t>* owners = other.share_count_.load(std::memory_order_acquire);
+        if (owners == nullptr) {
+            // Счётчик публикуется одним compare_exchange: при одновременном
+            // копировании const-массива проигравший поток удаляет свой
+            auto* created = new std::atomic<size_t>(1);
+            if (other.share_count_.compare_exchange_strong(owners, created,
+                                                           std::memory_order_acq_rel,
+                                                           std::memory_order_acquire)) {
+                owners = created;
+            } else {
+                delete created;
+            }
+        }
+        owners->fetch_add(1, std::memory_order_relaxed);
+        share_count_.store(owners, std::memory_order_relaxed);
+        before_head_.next = other.before_head_.next;
+        tail_ = other.tail_;
+        size_ = other.size_;
+    }
+    
+    // Освобождает цепочку без замера; деструктор и перемещение не создают
+    // гистограммы ради одной записи
+    void release_nodes() {
+        if (!release_share()) {
+            // Цепочку продолжают использовать другие копии
+            before_head_.next = nullptr;
+        }
+        // В режиме пула узлы сначала пополняют пул, остальные уничтожаются
+        while (before_head_.next != nullptr && pool_size_ < pool_limit_) {
+            Node* node = before_head_.next;
+            before_head_.next = node->next;
+            recycle_node(node);
+        }
+        if (before_head_.next != nullptr && reclaimer_ != nullptr) {
+            try {
+                reclaimer_->submit(std::make_unique<DetachedChain>(before_head_.next, allocator_));
+                before_head_.next = nullptr;
+            } catch (...) {
+                // Не удалось поставить задание в очередь - освобождаем сами
+            }
+        }
+        destroy_chain(allocator_, before_head_.next);
+        before_head_.next = tail_ = nullptr;
+        size_ = 0;
+    }
+    
+    // Отказывается от доли в разделяемой цепочке; возвращает true, если
+    // массив остался её единственным владельцем и должен освободить узлы
+    bool release_share() {
+        std::atomic<size_t>* owners = share_count_.load(std::memory_order_relaxed);
+        if (owners == nullptr) {
+            return true;
+        }
+        bool last = owners->fetch_sub(1, std::memory_order_acq_rel) == 1;
+        if (last) {
+            delete owners;
+        }
+        share_count_.store(nullptr, std::memory_order_relaxed);
+        return last;
+    }
+    
+    // Перед изменением: если цепочка разделяется с другими копиями,
+    // массив получает собственную глубокую копию элементов. Узлы из
+    // positions, указывающие в старую цепочку, заменяются соответствующими
+    // узлами новой (маркер before_begin остаётся как есть).
+    void detach(std::initializer_list<Node**> positions = {}) {
+        std::atomic<size_t>* shared_count = share_count_.load(std::memory_order_relaxed);
+        if (shared_count == nullptr) {
+            return;
+        }
+        if (shared_count->load(std::memory_order_acquire) == 1) {
+            // Остальные копии уже отказались от цепочки
+            delete shared_count;
+            share_count_.store(nullptr, std::memory_order_relaxed);
+            return;
+        }
+        
+        Node* shared_head = before_head_.next;
+        Node* shared_tail = tail_;
+        size_t shared_size = size_;
+        before_head_.next = tail_ = nullptr;
+        size_ = 0;
+        try {
+            for (Node* current = shared_head; current != nullptr; current = current->next) {
+                link_back(create_node(static_cast<const T&>(*current->data)));
+                for (Node** position : positions) {
+                    if (*position == current) {
+                        *position = tail_;
+                    }
+                }
+            }
+        } catch (...) {
+            destroy_chain(allocator_, before_head_.next);
+            before_head_.next = shared_head;
+            tail_ = shared_tail;
+            size_ = shared_size;
+            throw;
+        }
+        
+        share_count_.store(nullptr, std::memory_order_relaxed);
+        if (shared_count->fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            // Другие владельцы успели отказаться от цепочки во время копирования
+            delete shared_count;
+            destroy_chain(allocator_, shared_head);
+        }
+    }
+    
+    // Вставляет готовый узел после позиции
+    Node* link_after(Node* position, Node* new_node) {
+        Node*& link = position->next;
+        new_node->next = link;
+        link = new_node;
+        if (new_node->next == nullptr) {
+            tail_ = new_node;
+        }
+        size_++;
+        return new_node;
+    }
+    
+    Node* checked_position(const_iterator position) const {
+        Bounds::check(position.current_ != nullptr, "DynamicArray position is end()");
+        return position.current_;
+    }
+    
+    // Переносит узлы (first, last] из other после position; count - их число.
+    // При равных ресурсах узлы перевешиваются без копирования, иначе
+    // элементы перемещаются в память этого массива.
+    void transfer_after(Node* position, DynamicArray& other, Node* first, Node* last,
+                        size_t count) {
+        if (count == 0) {
+            return;
+        }
+        Node*& source_link = first->next;
+        Node* range_head = source_link;
+        
+        if (allocator_ == other.allocator_) {
+            source_link = last->next;
+            if (other.tail_ == last) {
+                other.tail_ = first == &other.before_head_ ? nullptr : first;
+            }
+            other.size_ -= count;
+            
+            Node*& link = position->next;
+            last->next = link;
+            link = range_head;
+            if (last->next == nullptr) {
+                tail_ = last;
+            }
+            size_ += count;
+            return;
+        }
+        
+        Node* stop = last->next;
+        for (Node* current = range_head; current != stop; current = current->next) {
+            position = link_after(position, create_node(std::move(*current->data)));
+        }
+        for (size_t i = 0; i < count; ++i) {
+            other.erase_after_node(first);
+        }
+    }
+    
+    // Удаляет узел, следующий за позицией
+    void erase_after_node(Node* position) {
+        Node*& link = position->next;
+        Node* victim = link;
+        Bounds::check(victim != nullptr, "No element after position");
+        link = victim->next;
+        if (victim == tail_) {
+            tail_ = position == &before_head_ ? nullptr : position;
+        }
+        destroy_node(victim);
+        size_--;
+    }
+    
+    void link_back(Node* new_node) {
+        if (empty()) {
+            before_head_.next = tail_ = new_node;
+        } else {
+            tail_->next = new_node;
+            tail_ = new_node;
+        }
+        size_++;
+    }
 };
\ No newline at end of file
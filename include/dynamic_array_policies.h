@@ -0,0 +1,196 @@
+#pragma once
+
+#include <memory>
+#include <memory_resource>
+#include <stdexcept>
+#include <type_traits>
+#include <cstddef>
+
+#include "cache_line.h"
+
+// Политики DynamicArray<T, Policies...>. Каждая политика относится к одной
+// категории (policy_category); в списке Policies каждая категория
+// указывается не больше одного раза и в любом порядке, для неуказанных
+// берутся значения по умолчанию: PmrAllocation, BatchGrowth<1024>,
+// PackedLayout, CheckedAccess. Так DynamicArray<T> и DynamicArray<T, CacheLineLayout>
+// остаются прежними типами с polymorphic_allocator.
+
+struct allocation_policy_tag {};
+struct growth_policy_tag {};
+struct layout_policy_tag {};
+struct bounds_policy_tag {};
+
+// ==================== Выделение памяти ====================
+
+// Память через std::pmr::polymorphic_allocator: ресурс выбирается во время
+// выполнения, каждое выделение - виртуальный вызов memory_resource.
+// Поддерживает пакетный интерфейс BulkMemoryResource (поведение по умолчанию).
+struct PmrAllocation {
+    using policy_category = allocation_policy_tag;
+    template<typename U>
+    using allocator = std::pmr::polymorphic_allocator<U>;
+};
+
+// Память через std::allocator (operator new), без состояния
+struct StdAllocation {
+    using policy_category = allocation_policy_tag;
+    template<typename U>
+    using allocator = std::allocator<U>;
+};
+
+// Аллокатор, вызывающий конкретный тип ресурса напрямую. Resource должен
+// иметь невиртуальные allocate(bytes, alignment) и
+// deallocate(ptr, bytes, alignment): тогда выделение целиком встраивается
+// в код контейнера. С этой политикой и с StdAllocation через аллокатор
+// выделяются и узлы списка, а не только элементы.
+template<typename U, typename Resource>
+class ResourceAllocator {
+private:
+    Resource* resource_;
+
+    template<typename, typename> friend class ResourceAllocator;
+
+public:
+    using value_type = U;
+
+    explicit ResourceAllocator(Resource* resource) noexcept : resource_(resource) {}
+
+    template<typename Other>
+    ResourceAllocator(const ResourceAllocator<Other, Resource>& other) noexcept
+        : resource_(other.resource_) {}
+
+    U* allocate(std::size_t n) {
+        return static_cast<U*>(resource_->allocate(n * sizeof(U), alignof(U)));
+    }
+
+    // Не noexcept: ресурс может сообщить об ошибке исключением
+    // (DynamicBlockMemoryResource - о неизвестном указателе)
+    void deallocate(U* ptr, std::size_t n) {
+        resource_->deallocate(ptr, n * sizeof(U), alignof(U));
+    }
+
+    Resource* resource() const noexcept {
+        return resource_;
+    }
+
+    template<typename Other>
+    bool operator==(const ResourceAllocator<Other, Resource>& other) const noexcept {
+        return resource_ == other.resource_;
+    }
+
+    template<typename Other>
+    bool operator!=(const ResourceAllocator<Other, Resource>& other) const noexcept {
+        return !(*this == other);
+    }
+};
+
+// Привязка контейнера к типу ресурса на этапе компиляции (например, MonotonicArena)
+template<typename Resource>
+struct ResourceAllocation {
+    using policy_category = allocation_policy_tag;
+    template<typename U>
+    using allocator = ResourceAllocator<U, Resource>;
+};
+
+// ==================== Рост ====================
+
+// Сколько элементов запрашивается у ресурса за один вызов, когда массив
+// растёт на диапазон (конструктор из диапазона, копирование, вставка
+// диапазона) и когда цепочка освобождается. Пакеты используются только с
+// PmrAllocation и ресурсом BulkMemoryResource.
+template<std::size_t BatchSize>
+struct BatchGrowth {
+    static_assert(BatchSize > 0, "batch size must be positive");
+    using policy_category = growth_policy_tag;
+    static constexpr std::size_t bulk_batch_size = BatchSize;
+};
+
+// Каждый элемент выделяется и освобождается отдельным вызовом
+using ElementGrowth = BatchGrowth<1>;
+
+// ==================== Размещение элементов ====================
+
+// Элементы выделяются вплотную, как есть (поведение по умолчанию)
+struct PackedLayout {
+    using policy_category = layout_policy_tag;
+    template<typename T>
+    using slot_type = T;
+};
+
+// Каждый элемент выравнивается и дополняется до кэш-линии, чтобы элементы,
+// изменяемые разными потоками, не делили одну линию (false sharing)
+struct CacheLineLayout {
+    using policy_category = layout_policy_tag;
+    template<typename T>
+    struct alignas(cache_line_size) slot_type {
+        alignas(T) unsigned char storage[sizeof(T)];
+    };
+};
+
+// ==================== Проверка границ ====================
+
+// Обращение к элементу пустого массива или за end() бросает
+// std::out_of_range (поведение по умолчанию)
+struct CheckedAccess {
+    using policy_category = bounds_policy_tag;
+    static void check(bool valid, const char* message) {
+        if (!valid) {
+            throw std::out_of_range(message);
+        }
+    }
+};
+
+// Проверки не выполняются: нарушение - неопределённое поведение, как у
+// operator[] стандартных контейнеров
+struct UncheckedAccess {
+    using policy_category = bounds_policy_tag;
+    static void check(bool, const char*) noexcept {}
+};
+
+// ==================== Выбор политик ====================
+
+template<typename Policy>
+struct policy_identity {
+    using type = Policy;
+};
+
+// Категория политики; void для типов, не являющихся политиками
+template<typename Policy, typename = void>
+struct policy_category : policy_identity<void> {};
+
+template<typename Policy>
+struct policy_category<Policy, std::void_t<typename Policy::policy_category>>
+    : policy_identity<typename Policy::policy_category> {};
+
+template<typename Policy>
+using policy_category_t = typename policy_category<Policy>::type;
+
+// Первая политика категории Category из Policies или Default
+template<typename Category, typename Default, typename... Policies>
+struct select_policy : policy_identity<Default> {};
+
+template<typename Category, typename Default, typename First, typename... Rest>
+struct select_policy<Category, Default, First, Rest...>
+    : std::conditional_t<std::is_same_v<policy_category_t<First>, Category>,
+                         policy_identity<First>,
+                         select_policy<Category, Default, Rest...>> {};
+
+template<typename Category, typename Default, typename... Policies>
+using select_policy_t = typename select_policy<Category, Default, Policies...>::type;
+
+// Сколько политик категории Category в Policies
+template<typename Category, typename... Policies>
+inline constexpr std::size_t policy_count_v =
+    (std::size_t(0) + ... + std::size_t(std::is_same_v<policy_category_t<Policies>, Category>));
+
+// Каждая политика распознана и ни одна категория не повторяется
+template<typename... Policies>
+inline constexpr bool valid_policies_v =
+    policy_count_v<allocation_policy_tag, Policies...> <= 1 &&
+    policy_count_v<growth_policy_tag, Policies...> <= 1 &&
+    policy_count_v<layout_policy_tag, Policies...> <= 1 &&
+    policy_count_v<bounds_policy_tag, Policies...> <= 1 &&
+    policy_count_v<allocation_policy_tag, Policies...> +
+        policy_count_v<growth_policy_tag, Policies...> +
+        policy_count_v<layout_policy_tag, Policies...> +
+        policy_count_v<bounds_policy_tag, Policies...> == sizeof...(Policies);
@@ -0,0 +1,399 @@
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <memory_resource>
+#include <type_traits>
+#include <utility>
+
+#include "dynamic_array.h"
+
+// Ленивые представления (views) над DynamicArray и друг над другом.
+//
+// Представления ничего не копируют и не выделяют память: они хранят ссылку
+// на исходный контейнер (или вложенное представление по значению) и
+// вычисляют элементы при обходе. Композиция через operator|:
+//
+//     auto values = array | views::filter([](const ComplexType& c) { return c.id > 10; })
+//                         | views::transform([](const ComplexType& c) { return c.value; })
+//                         | views::take(100);
+//     auto result = views::to_dynamic_array(values, alloc);   // единственная аллокация
+//
+// Как и итераторы, представления становятся недействительными после
+// изменения структуры исходного контейнера.
+namespace views {
+
+// Признак представления: такие объекты дёшево копируются и хранятся по значению
+struct ViewBase {};
+
+template<typename Range>
+using iterator_t = decltype(std::begin(std::declval<Range&>()));
+
+template<typename Range>
+using reference_t = decltype(*std::declval<iterator_t<Range>&>());
+
+// Представление над контейнером, хранящее ссылку на него. Обход идёт
+// только через const-интерфейс: неконстантный begin() у DynamicArray в
+// режиме copy-on-write отделил бы (скопировал) разделяемую цепочку.
+template<typename Range>
+class RefView : public ViewBase {
+private:
+    const Range* range_;
+
+public:
+    explicit RefView(const Range& range) : range_(&range) {}
+
+    auto begin() const { return std::begin(*range_); }
+    auto end() const { return std::end(*range_); }
+};
+
+// Контейнер оборачивается в RefView, представление копируется как есть.
+// Временные контейнеры запрещены: представление пережило бы их.
+template<typename Range>
+auto all(Range&& range) {
+    using Plain = std::remove_cv_t<std::remove_reference_t<Range>>;
+    if constexpr (std::is_base_of_v<ViewBase, Plain>) {
+        return Plain(std::forward<Range>(range));
+    } else {
+        static_assert(std::is_lvalue_reference_v<Range>,
+                      "views over temporary containers would dangle");
+        return RefView<std::remove_reference_t<Range>>(range);
+    }
+}
+
+template<typename Range>
+using all_t = decltype(all(std::declval<Range>()));
+
+// ==================== filter ====================
+
+template<typename Base, typename Predicate>
+class FilterView : public ViewBase {
+private:
+    Base base_;
+    Predicate predicate_;
+
+public:
+    class Iterator {
+    private:
+        iterator_t<const Base> current_;
+        iterator_t<const Base> end_;
+        const Predicate* predicate_;
+
+        void skip() {
+            while (current_ != end_ && !(*predicate_)(*current_)) {
+                ++current_;
+            }
+        }
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using reference = reference_t<const Base>;
+        using value_type = std::remove_cv_t<std::remove_reference_t<reference>>;
+        using difference_type = std::ptrdiff_t;
+        using pointer = std::add_pointer_t<reference>;
+
+        Iterator() : current_(), end_(), predicate_(nullptr) {}
+
+        Iterator(iterator_t<const Base> current, iterator_t<const Base> end,
+                 const Predicate* predicate)
+            : current_(current), end_(end), predicate_(predicate) {
+            skip();
+        }
+
+        reference operator*() const { return *current_; }
+
+        Iterator& operator++() {
+            ++current_;
+            skip();
+            return *this;
+        }
+
+        Iterator operator++(int) {
+            Iterator temp = *this;
+            ++(*this);
+            return temp;
+        }
+
+        bool operator==(const Iterator& other) const { return current_ == other.current_; }
+        bool operator!=(const Iterator& other) const { return !(*this == other); }
+    };
+
+    FilterView(Base base, Predicate predicate)
+        : base_(std::move(base)), predicate_(std::move(predicate)) {}
+
+    Iterator begin() const { return Iterator(std::begin(base_), std::end(base_), &predicate_); }
+    Iterator end() const { return Iterator(std::end(base_), std::end(base_), &predicate_); }
+};
+
+// ==================== transform ====================
+
+template<typename Base, typename Function>
+class TransformView : public ViewBase {
+private:
+    Base base_;
+    Function function_;
+
+public:
+    class Iterator {
+    private:
+        iterator_t<const Base> current_;
+        const Function* function_;
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using reference = decltype(std::declval<const Function&>()(*std::declval<iterator_t<const Base>&>()));
+        using value_type = std::remove_cv_t<std::remove_reference_t<reference>>;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+
+        Iterator() : current_(), function_(nullptr) {}
+
+        Iterator(iterator_t<const Base> current, const Function* function)
+            : current_(current), function_(function) {}
+
+        reference operator*() const { return (*function_)(*current_); }
+
+        Iterator& operator++() {
+            ++current_;
+            return *this;
+        }
+
+        Iterator operator++(int) {
+            Iterator temp = *this;
+            ++(*this);
+            return temp;
+        }
+
+        bool operator==(const Iterator& other) const { return current_ == other.current_; }
+        bool operator!=(const Iterator& other) const { return !(*this == other); }
+    };
+
+    TransformView(Base base, Function function)
+        : base_(std::move(base)), function_(std::move(function)) {}
+
+    Iterator begin() const { return Iterator(std::begin(base_), &function_); }
+    Iterator end() const { return Iterator(std::end(base_), &function_); }
+};
+
+// ==================== take ====================
+
+// Итератор, проходящий не более count элементов
+template<typename BaseIterator>
+class CountedIterator {
+private:
+    BaseIterator current_;
+    BaseIterator end_;
+    std::size_t remaining_;
+
+    bool at_end() const { return remaining_ == 0 || current_ == end_; }
+
+public:
+    using iterator_category = std::forward_iterator_tag;
+    using reference = decltype(*std::declval<BaseIterator&>());
+    using value_type = std::remove_cv_t<std::remove_reference_t<reference>>;
+    using difference_type = std::ptrdiff_t;
+    using pointer = std::add_pointer_t<reference>;
+
+    CountedIterator() : current_(), end_(), remaining_(0) {}
+
+    CountedIterator(BaseIterator current, BaseIterator end, std::size_t count)
+        : current_(current), end_(end), remaining_(count) {}
+
+    reference operator*() const { return *current_; }
+
+    CountedIterator& operator++() {
+        ++current_;
+        --remaining_;
+        return *this;
+    }
+
+    CountedIterator operator++(int) {
+        CountedIterator temp = *this;
+        ++(*this);
+        return temp;
+    }
+
+    bool operator==(const CountedIterator& other) const {
+        if (at_end() || other.at_end()) {
+            return at_end() && other.at_end();
+        }
+        return current_ == other.current_;
+    }
+
+    bool operator!=(const CountedIterator& other) const { return !(*this == other); }
+};
+
+template<typename Base>
+class TakeView : public ViewBase {
+private:
+    Base base_;
+    std::size_t count_;
+
+public:
+    using Iterator = CountedIterator<iterator_t<const Base>>;
+
+    TakeView(Base base, std::size_t count) : base_(std::move(base)), count_(count) {}
+
+    Iterator begin() const { return Iterator(std::begin(base_), std::end(base_), count_); }
+    Iterator end() const { return Iterator(std::end(base_), std::end(base_), 0); }
+};
+
+// ==================== drop ====================
+
+template<typename Base>
+class DropView : public ViewBase {
+private:
+    Base base_;
+    std::size_t count_;
+
+public:
+    using Iterator = iterator_t<const Base>;
+
+    DropView(Base base, std::size_t count) : base_(std::move(base)), count_(count) {}
+
+    Iterator begin() const {
+        Iterator it = std::begin(base_);
+        Iterator last = std::end(base_);
+        for (std::size_t i = 0; i < count_ && it != last; ++i) {
+            ++it;
+        }
+        return it;
+    }
+
+    Iterator end() const { return std::end(base_); }
+};
+
+// ==================== chunk ====================
+
+// Пара итераторов как представление; элемент ChunkView
+template<typename Iterator>
+class SubRange : public ViewBase {
+private:
+    Iterator first_;
+    Iterator last_;
+
+public:
+    SubRange(Iterator first, Iterator last) : first_(first), last_(last) {}
+
+    Iterator begin() const { return first_; }
+    Iterator end() const { return last_; }
+};
+
+template<typename Base>
+class ChunkView : public ViewBase {
+private:
+    Base base_;
+    std::size_t size_;
+
+public:
+    using Chunk = SubRange<CountedIterator<iterator_t<const Base>>>;
+
+    class Iterator {
+    private:
+        iterator_t<const Base> current_;
+        iterator_t<const Base> end_;
+        std::size_t size_;
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Chunk;
+        using reference = Chunk;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+
+        Iterator() : current_(), end_(), size_(0) {}
+
+        Iterator(iterator_t<const Base> current, iterator_t<const Base> end, std::size_t size)
+            : current_(current), end_(end), size_(size) {}
+
+        Chunk operator*() const {
+            using Counted = CountedIterator<iterator_t<const Base>>;
+            return Chunk(Counted(current_, end_, size_), Counted(end_, end_, 0));
+        }
+
+        Iterator& operator++() {
+            for (std::size_t i = 0; i < size_ && current_ != end_; ++i) {
+                ++current_;
+            }
+            return *this;
+        }
+
+        Iterator operator++(int) {
+            Iterator temp = *this;
+            ++(*this);
+            return temp;
+        }
+
+        bool operator==(const Iterator& other) const { return current_ == other.current_; }
+        bool operator!=(const Iterator& other) const { return !(*this == other); }
+    };
+
+    ChunkView(Base base, std::size_t size) : base_(std::move(base)), size_(size > 0 ? size : 1) {}
+
+    Iterator begin() const { return Iterator(std::begin(base_), std::end(base_), size_); }
+    Iterator end() const { return Iterator(std::end(base_), std::end(base_), size_); }
+};
+
+// ==================== Адаптеры для operator| ====================
+
+template<typename Predicate>
+struct FilterAdaptor { Predicate predicate; };
+
+template<typename Function>
+struct TransformAdaptor { Function function; };
+
+struct TakeAdaptor { std::size_t count; };
+struct DropAdaptor { std::size_t count; };
+struct ChunkAdaptor { std::size_t size; };
+
+template<typename Predicate>
+FilterAdaptor<Predicate> filter(Predicate predicate) { return {std::move(predicate)}; }
+
+template<typename Function>
+TransformAdaptor<Function> transform(Function function) { return {std::move(function)}; }
+
+inline TakeAdaptor take(std::size_t count) { return {count}; }
+inline DropAdaptor drop(std::size_t count) { return {count}; }
+inline ChunkAdaptor chunk(std::size_t size) { return {size}; }
+
+template<typename Range, typename Predicate>
+auto operator|(Range&& range, FilterAdaptor<Predicate> adaptor) {
+    return FilterView<all_t<Range>, Predicate>(all(std::forward<Range>(range)),
+                                               std::move(adaptor.predicate));
+}
+
+template<typename Range, typename Function>
+auto operator|(Range&& range, TransformAdaptor<Function> adaptor) {
+    return TransformView<all_t<Range>, Function>(all(std::forward<Range>(range)),
+                                                 std::move(adaptor.function));
+}
+
+template<typename Range>
+auto operator|(Range&& range, TakeAdaptor adaptor) {
+    return TakeView<all_t<Range>>(all(std::forward<Range>(range)), adaptor.count);
+}
+
+template<typename Range>
+auto operator|(Range&& range, DropAdaptor adaptor) {
+    return DropView<all_t<Range>>(all(std::forward<Range>(range)), adaptor.count);
+}
+
+template<typename Range>
+auto operator|(Range&& range, ChunkAdaptor adaptor) {
+    return ChunkView<all_t<Range>>(all(std::forward<Range>(range)), adaptor.size);
+}
+
+// Материализует представление в новый DynamicArray; это единственное место,
+// где цепочка представлений выделяет память
+template<typename Range,
+         typename T = std::remove_cv_t<std::remove_reference_t<reference_t<const Range>>>>
+DynamicArray<T> to_dynamic_array(const Range& range,
+                                 std::pmr::polymorphic_allocator<T> alloc = {}) {
+    DynamicArray<T> result(alloc);
+    for (auto it = std::begin(range); it != std::end(range); ++it) {
+        result.emplace_back(*it);
+    }
+    return result;
+}
+
+} // namespace views
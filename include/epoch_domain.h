@@ -0,0 +1,103 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+
+#include "background_reclaimer.h"
+#include "cache_line.h"
+
+// Эпохальная (epoch-based, в духе RCU) схема отложенного освобождения памяти
+// для структур с одним писателем и многими читателями.
+//
+// Читатель на время обхода занимает слот и публикует в нём текущую эпоху
+// (pin()); писатель, отсоединив данные, отдаёт их в retire(), помечая
+// эпохой изъятия, и сдвигает глобальную эпоху. Данные уничтожаются
+// (reclaim()), только когда ни один занятый слот не хранит эпоху, не
+// превосходящую эпоху изъятия, то есть когда ни один читатель не мог их
+// увидеть. Читатели не берут блокировок и ничего не пишут в общие данные,
+// кроме собственного слота; слоты разнесены по кэш-линиям.
+class EpochDomain {
+private:
+    static constexpr std::uint64_t idle_epoch = 0;
+
+    struct alignas(cache_line_size) ReaderSlot {
+        std::atomic<std::uint64_t> epoch{idle_epoch};
+        std::atomic<bool> in_use{false};
+    };
+
+    struct Retired {
+        std::uint64_t epoch;
+        std::unique_ptr<ReclaimJob> job;
+    };
+
+    std::unique_ptr<ReaderSlot[]> slots_;
+    std::size_t slot_count_;
+    alignas(cache_line_size) std::atomic<std::uint64_t> global_epoch_;
+    std::deque<Retired> retired_;
+    std::size_t reclaim_threshold_;
+    BackgroundReclaimer* reclaimer_;
+    mutable std::mutex retired_mutex_;
+
+    ReaderSlot* acquire_slot();
+    std::uint64_t oldest_reader_epoch() const;
+
+public:
+    // Закреплённая эпоха читателя; пока объект жив, данные, видимые
+    // читателю, не будут освобождены
+    class Guard {
+    private:
+        ReaderSlot* slot_;
+
+        friend class EpochDomain;
+        explicit Guard(ReaderSlot* slot) : slot_(slot) {}
+
+    public:
+        Guard() : slot_(nullptr) {}
+        Guard(Guard&& other) noexcept : slot_(other.slot_) { other.slot_ = nullptr; }
+        Guard& operator=(Guard&& other) noexcept;
+        Guard(const Guard&) = delete;
+        Guard& operator=(const Guard&) = delete;
+        ~Guard();
+
+        // Снимает закрепление досрочно
+        void release();
+
+        bool active() const { return slot_ != nullptr; }
+    };
+
+    // reader_slots - сколько читателей могут быть закреплены одновременно
+    // (при нехватке pin() ждёт освобождения слота); reclaim_threshold - после
+    // скольких накопленных retire() писатель сам вызывает reclaim()
+    explicit EpochDomain(std::size_t reader_slots = 64, std::size_t reclaim_threshold = 64);
+
+    EpochDomain(const EpochDomain&) = delete;
+    EpochDomain& operator=(const EpochDomain&) = delete;
+
+    // Освобождает всё отложенное; к этому моменту читателей быть не должно
+    ~EpochDomain();
+
+    // Закрепляет текущую эпоху за вызывающим читателем
+    Guard pin();
+
+    // Передаёт отсоединённые писателем данные на отложенное освобождение
+    void retire(std::unique_ptr<ReclaimJob> job);
+
+    // Освобождает данные, которые уже не может видеть ни один читатель;
+    // возвращает число освобождённых заданий
+    std::size_t reclaim();
+
+    // Число ещё не освобождённых заданий
+    std::size_t retired_count() const;
+
+    std::uint64_t epoch() const;
+
+    // Если задан, безопасные задания выполняются не в потоке писателя, а
+    // передаются фоновому потоку; reclaimer должен пережить домен
+    void set_reclaimer(BackgroundReclaimer* reclaimer);
+
+    BackgroundReclaimer* reclaimer() const;
+};
@@ -0,0 +1,281 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <ostream>
+
+// Гистограмма задержек в стиле HDR: значения до 128 нс хранятся точно, дальше
+// каждая степень двойки делится на 64 поддиапазона, поэтому относительная
+// погрешность перцентилей не превышает 1/64. Значения больше max_trackable()
+// учитываются в последнем интервале.
+class LatencyHistogram {
+private:
+    static constexpr unsigned sub_bucket_bits = 7;
+    static constexpr std::uint64_t sub_bucket_count = std::uint64_t(1) << sub_bucket_bits;
+    static constexpr std::uint64_t sub_bucket_half = sub_bucket_count / 2;
+    static constexpr unsigned max_value_bits = 40;   // ~18 минут в наносекундах
+    static constexpr std::size_t bucket_count =
+        (max_value_bits - sub_bucket_bits + 1) * sub_bucket_half + sub_bucket_count;
+
+    std::array<std::uint64_t, bucket_count> counts_{};
+    std::uint64_t total_count_ = 0;
+    std::uint64_t min_ = 0;
+    std::uint64_t max_ = 0;
+    long double sum_ = 0;
+
+    static unsigned highest_bit(std::uint64_t value) {
+        unsigned bit = 0;
+        while (value >>= 1) {
+            ++bit;
+        }
+        return bit;
+    }
+
+    static std::size_t bucket_index(std::uint64_t value) {
+        if (value < sub_bucket_count) {
+            return static_cast<std::size_t>(value);
+        }
+        unsigned shift = highest_bit(value) - (sub_bucket_bits - 1);
+        return static_cast<std::size_t>(shift * sub_bucket_half + (value >> shift));
+    }
+
+    // Наибольшее значение, попадающее в интервал index
+    static std::uint64_t bucket_highest_value(std::size_t index) {
+        if (index < sub_bucket_count) {
+            return index;
+        }
+        unsigned shift = static_cast<unsigned>(index / sub_bucket_half - 1);
+        std::uint64_t sub_bucket = index - shift * sub_bucket_half;
+        return ((sub_bucket + 1) << shift) - 1;
+    }
+
+public:
+    static constexpr std::uint64_t max_trackable() {
+        return (std::uint64_t(1) << (max_value_bits + 1)) - 1;
+    }
+
+    void record(std::uint64_t nanoseconds) {
+        std::uint64_t clamped = nanoseconds < max_trackable() ? nanoseconds : max_trackable();
+        counts_[bucket_index(clamped)]++;
+        if (total_count_ == 0 || nanoseconds < min_) {
+            min_ = nanoseconds;
+        }
+        if (nanoseconds > max_) {
+            max_ = nanoseconds;
+        }
+        sum_ += nanoseconds;
+        total_count_++;
+    }
+
+    std::uint64_t count() const {
+        return total_count_;
+    }
+
+    std::uint64_t min() const {
+        return min_;
+    }
+
+    std::uint64_t max() const {
+        return max_;
+    }
+
+    double mean() const {
+        return total_count_ == 0 ? 0.0 : static_cast<double>(sum_ / total_count_);
+    }
+
+    // Значение, не меньше которого percentile процентов записей (0..100]
+    std::uint64_t percentile(double percentile) const {
+        if (total_count_ == 0) {
+            return 0;
+        }
+        if (percentile > 100.0) {
+            percentile = 100.0;
+        }
+        auto target = static_cast<std::uint64_t>(percentile / 100.0 * total_count_ + 0.5);
+        if (target == 0) {
+            target = 1;
+        }
+        std::uint64_t seen = 0;
+        for (std::size_t i = 0; i < bucket_count; ++i) {
+            seen += counts_[i];
+            if (seen >= target) {
+                std::uint64_t value = bucket_highest_value(i);
+                return value < max_ ? value : max_;
+            }
+        }
+        return max_;
+    }
+
+    void merge(const LatencyHistogram& other) {
+        if (other.total_count_ == 0) {
+            return;
+        }
+        for (std::size_t i = 0; i < bucket_count; ++i) {
+            counts_[i] += other.counts_[i];
+        }
+        if (total_count_ == 0 || other.min_ < min_) {
+            min_ = other.min_;
+        }
+        if (other.max_ > max_) {
+            max_ = other.max_;
+        }
+        sum_ += other.sum_;
+        total_count_ += other.total_count_;
+    }
+
+    void reset() {
+        counts_.fill(0);
+        total_count_ = 0;
+        min_ = 0;
+        max_ = 0;
+        sum_ = 0;
+    }
+
+    // Одна строка: число записей и p50/p99/p999/max в наносекундах
+    void report(std::ostream& out, const char* name) const {
+        out << name << ": count=" << total_count_
+            << " p50=" << percentile(50.0) << "ns"
+            << " p99=" << percentile(99.0) << "ns"
+            << " p999=" << percentile(99.9) << "ns"
+            << " max=" << max_ << "ns" << std::endl;
+    }
+};
+
+// Записывает в гистограмму время жизни объекта; с nullptr замер не ведётся
+class ScopedLatencyTimer {
+private:
+    LatencyHistogram* histogram_;
+    std::chrono::steady_clock::time_point start_;
+
+public:
+    explicit ScopedLatencyTimer(LatencyHistogram* histogram) noexcept
+        : histogram_(histogram),
+          start_(histogram != nullptr ? std::chrono::steady_clock::now()
+                                      : std::chrono::steady_clock::time_point()) {}
+
+    explicit ScopedLatencyTimer(LatencyHistogram& histogram) noexcept
+        : ScopedLatencyTimer(&histogram) {}
+
+    ScopedLatencyTimer(const ScopedLatencyTimer&) = delete;
+    ScopedLatencyTimer& operator=(const ScopedLatencyTimer&) = delete;
+
+    ~ScopedLatencyTimer() {
+        if (histogram_ == nullptr) {
+            return;
+        }
+        auto elapsed = std::chrono::steady_clock::now() - start_;
+        histogram_->record(static_cast<std::uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+    }
+};
+
+// Гистограммы горячих операций одного DynamicArray
+struct DynamicArrayLatency {
+    LatencyHistogram push_back;
+    LatencyHistogram pop_back;
+    LatencyHistogram copy;
+    LatencyHistogram move;
+    LatencyHistogram clear;
+
+    void report(std::ostream& out) const {
+        push_back.report(out, "push_back");
+        pop_back.report(out, "pop_back");
+        copy.report(out, "copy");
+        move.report(out, "move");
+        clear.report(out, "clear");
+    }
+};
+
+// Набор гистограмм, создаваемый при первом замере. Гистограммы весят
+// десятки килобайт, а контейнеров может быть много (в том числе вложенных),
+// поэтому объект хранит только указатель. Память берётся malloc в обход
+// operator new, чтобы инструментирование не попадало в учёт выделений
+// программы; если её не хватило, замер пропускается, а не бросает
+// исключение.
+template<typename Stats>
+class LazyLatencyStats {
+private:
+    Stats* stats_ = nullptr;
+
+public:
+    LazyLatencyStats() = default;
+    LazyLatencyStats(const LazyLatencyStats&) = delete;
+    LazyLatencyStats& operator=(const LazyLatencyStats&) = delete;
+
+    ~LazyLatencyStats() {
+        reset();
+    }
+
+    // Гистограмма для замера; набор создаётся при первом обращении.
+    // nullptr, если памяти под набор нет
+    LatencyHistogram* record(LatencyHistogram Stats::*histogram) noexcept {
+        if (stats_ == nullptr) {
+            void* memory = std::malloc(sizeof(Stats));
+            if (memory == nullptr) {
+                return nullptr;
+            }
+            stats_ = new (memory) Stats();
+        }
+        return &(stats_->*histogram);
+    }
+
+    // Гистограмма для замера, только если набор уже создан: деструктор и
+    // перемещение не создают его ради одной записи
+    LatencyHistogram* record_if_allocated(LatencyHistogram Stats::*histogram) noexcept {
+        return stats_ != nullptr ? &(stats_->*histogram) : nullptr;
+    }
+
+    // Гистограммы для чтения; пока замеров не было - пустой набор
+    const Stats& get() const {
+        static const Stats empty{};
+        return stats_ != nullptr ? *stats_ : empty;
+    }
+
+    void reset() noexcept {
+        if (stats_ != nullptr) {
+            stats_->~Stats();
+            std::free(stats_);
+            stats_ = nullptr;
+        }
+    }
+
+    void swap(LazyLatencyStats& other) noexcept {
+        Stats* stats = stats_;
+        stats_ = other.stats_;
+        other.stats_ = stats;
+    }
+};
+
+
+// Гистограммы операций memory_resource
+// Пакетный вызов - один замер в своей гистограмме: его время зависит от
+// размера пачки и исказило бы распределение одиночных вызовов
+struct MemoryResourceLatency {
+    LatencyHistogram allocate;
+    LatencyHistogram deallocate;
+    LatencyHistogram allocate_bulk;
+    LatencyHistogram deallocate_bulk;
+
+    void report(std::ostream& out) const {
+        allocate.report(out, "allocate");
+        deallocate.report(out, "deallocate");
+        allocate_bulk.report(out, "allocate_bulk");
+        deallocate_bulk.report(out, "deallocate_bulk");
+    }
+};
+
+// Инструментирование включается флагом LAB5_LATENCY_HISTOGRAMS (опция CMake
+// с тем же именем); без него макрос раскрывается в пустоту и замеры, как и
+// поля с гистограммами, полностью отсутствуют в коде
+#ifdef LAB5_LATENCY_HISTOGRAMS
+#define LAB5_LATENCY_CONCAT_IMPL(a, b) a##b
+#define LAB5_LATENCY_CONCAT(a, b) LAB5_LATENCY_CONCAT_IMPL(a, b)
+#define LAB5_MEASURE_LATENCY(histogram) \
+    ScopedLatencyTimer LAB5_LATENCY_CONCAT(latency_timer_, __LINE__)(histogram)
+#else
+#define LAB5_MEASURE_LATENCY(histogram) ((void)0)
+#endif
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <memory_resource>
+#include <mutex>
+#include <string>
+#include <cstddef>
+#include <cstdint>
+
+// memory_resource, выделяющий память из отображённого в память файла
+// (mmap, MAP_SHARED). Файл растёт по мере необходимости, а вытеснение
+// страниц на диск и их подкачку выполняет страничный кэш ядра, поэтому
+// объём данных ограничен размером диска, а не оперативной памяти.
+//
+// Вся служебная информация хранится в самом файле в виде смещений от его
+// начала, а не указателей: после повторного открытия (в том числе в другом
+// процессе и по другому адресу) ранее выделенные блоки и корневые объекты
+// остаются действительными. Корни (root) - несколько именованных номером
+// ячеек заголовка, через которые находятся сохранённые структуры. Файл
+// по возможности отображается по тому же адресу, что и при прошлом
+// открытии, - тогда действительны и указатели, записанные в блоки.
+
+//
+// Блоки выделяются классами размеров (степени двойки) со списками свободных
+// блоков для каждого класса; выравнивание поддерживается до размера
+// страницы. Ресурс можно использовать напрямую или как upstream для
+// DynamicBlockMemoryResource (но тогда учёт блоков последнего не сохраняется
+// в файле). Потокобезопасен.
+class MappedFileMemoryResource : public std::pmr::memory_resource {
+public:
+    static constexpr std::size_t root_count = 16;
+
+private:
+    struct FileHeader;
+
+    std::string path_;
+    int fd_;
+    char* base_;              // начало зарезервированного диапазона адресов
+    std::size_t reserved_;    // размер резерва; файл не может вырасти больше
+    std::size_t mapped_;      // сколько байт файла сейчас отображено
+    mutable std::mutex mutex_;
+
+    FileHeader* header() const;
+    void grow(std::size_t required);
+    void map_file(std::size_t size);
+
+protected:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+    void do_deallocate(void* ptr, std::size_t bytes, std::size_t alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+public:
+    // Открывает файл или создаёт новый размером initial_size. max_size -
+    // резервируемое адресное пространство, предел роста файла.
+    explicit MappedFileMemoryResource(const std::string& path,
+                                      std::size_t initial_size = std::size_t(1) << 20,
+                                      std::size_t max_size = std::size_t(1) << 36);
+
+    MappedFileMemoryResource(const MappedFileMemoryResource&) = delete;
+    MappedFileMemoryResource& operator=(const MappedFileMemoryResource&) = delete;
+
+    // Сбрасывает данные на диск и закрывает файл; выделенные блоки остаются в файле
+    ~MappedFileMemoryResource() override;
+
+    // Синхронно записывает изменённые страницы на диск
+    void flush();
+
+    std::size_t allocated_blocks_count() const;
+    std::size_t allocated_bytes() const;
+    std::size_t file_size() const;
+    const std::string& path() const;
+
+    // Перевод между адресами текущего отображения и смещениями в файле
+    std::uint64_t offset_of(const void* ptr) const;
+    void* pointer_at(std::uint64_t offset) const;
+
+    // Корневые ячейки: nullptr означает пустую ячейку
+    void* root(std::size_t index) const;
+    void set_root(std::size_t index, const void* ptr);
+};
@@ -2,33 +2,97 @@
 
 #include <memory_resource>
 #include <map>
+#include <mutex>
+#include <vector>
 #include <cstddef>
 
-class DynamicBlockMemoryResource : public std::pmr::memory_resource {
+#include "bulk_memory_resource.h"
+#include "cache_line.h"
+#include "latency_histogram.h"
+
+// Режим выделения блоков
+enum class AllocationMode {
+    Packed,            // блоки выделяются как есть, соседние могут делить кэш-линию
+    CacheLineAligned   // каждый блок выравнивается и дополняется до кэш-линии
+};
+
+// Потокобезопасен: учёт блоков защищён мьютексом, поэтому память можно
+// освобождать из другого потока (например, BackgroundReclaimer).
+// allocate_bulk() берёт у upstream одну область на все блоки пачки и
+// регистрирует её одной записью; область возвращается upstream, когда
+// освобождён последний её блок.
+class DynamicBlockMemoryResource : public BulkMemoryResource {
 private:
+    // Отдельный блок или область allocate_bulk (stride != 0)
     struct BlockInfo {
         void* ptr;
         std::size_t size;
+        std::size_t alignment;
+        std::size_t stride;          // шаг блоков области; 0 - отдельный блок
+        std::vector<bool> live;      // какие блоки области ещё выделены
+        std::size_t live_count;
         
-        BlockInfo(void* p = nullptr, std::size_t s = 0);
+        BlockInfo(void* p = nullptr, std::size_t s = 0, 
+                  std::size_t a = alignof(std::max_align_t));
     };
     
     std::map<void*, BlockInfo> allocated_blocks_;
+    std::size_t live_blocks_;
     std::pmr::memory_resource* upstream_;
+    AllocationMode mode_;
+    bool logging_;
+    mutable std::mutex mutex_;
+    
+#ifdef LAB5_LATENCY_HISTOGRAMS
+    MemoryResourceLatency latency_;
+#endif
     
 protected:
     void* do_allocate(std::size_t bytes, std::size_t alignment) override;
     void do_deallocate(void* ptr, std::size_t bytes, std::size_t alignment) override;
     bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+    void do_allocate_bulk(std::size_t count, std::size_t bytes, std::size_t alignment,
+                          void** out) override;
+    void do_deallocate_bulk(std::size_t count, std::size_t bytes, std::size_t alignment,
+                            void* const* ptrs) override;
+    
+private:
+    // Размер и выравнивание блока с учётом режима
+    void adjust_for_mode(std::size_t& bytes, std::size_t& alignment) const;
+    
+    using BlockMap = std::map<void*, BlockInfo>;
+    
+    // Снимает учёт блока и при необходимости возвращает память upstream;
+    // вызывается под mutex_. hint - запись, в которой блок вероятно лежит
+    // (end() - неизвестно); возвращает запись для следующего вызова.
+    BlockMap::iterator release_block(void* ptr, std::size_t bytes, BlockMap::iterator hint);
     
 public:
     explicit DynamicBlockMemoryResource(std::pmr::memory_resource* upstream = 
                                         std::pmr::get_default_resource());
     
+    explicit DynamicBlockMemoryResource(AllocationMode mode,
+                                        std::pmr::memory_resource* upstream = 
+                                        std::pmr::get_default_resource());
+    
     DynamicBlockMemoryResource(const DynamicBlockMemoryResource&) = delete;
     DynamicBlockMemoryResource& operator=(const DynamicBlockMemoryResource&) = delete;
     
     ~DynamicBlockMemoryResource() override;
     
+    // Число выделенных блоков, включая блоки внутри областей allocate_bulk
     std::size_t allocated_blocks_count() const;
-};
\ No newline at end of file
+    
+    // Число блоков и областей, полученных у upstream и ещё не возвращённых
+    std::size_t upstream_blocks_count() const;
+    
+    AllocationMode allocation_mode() const;
+    
+    // Включение/отключение вывода каждой операции в std::cout
+    void set_logging(bool enabled);
+    
+#ifdef LAB5_LATENCY_HISTOGRAMS
+    // Гистограммы задержек do_allocate/do_deallocate
+    const MemoryResourceLatency& latency_stats() const;
+#endif
+};
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <memory_resource>
+#include <new>
+#include <cstddef>
+#include <cstdint>
+
+// Арена с линейным выделением без виртуальных функций: allocate сдвигает
+// указатель внутри текущего блока, deallocate ничего не делает, память
+// возвращается целиком в release() или деструкторе. Блоки берутся у
+// upstream-ресурса и растут вдвое. Предназначена для
+// DynamicArray<T, ResourceAllocation<MonotonicArena>>: вызовы allocate
+// встраиваются в код контейнера. Не потокобезопасна.
+class MonotonicArena {
+private:
+    struct Chunk {
+        Chunk* previous;
+        std::size_t bytes;
+    };
+
+    std::pmr::memory_resource* upstream_;
+    Chunk* chunks_;
+    char* current_;
+    char* end_;
+    std::size_t next_chunk_bytes_;
+    std::size_t allocated_bytes_;
+
+    void* allocate_slow(std::size_t bytes, std::size_t alignment) {
+        std::size_t required = sizeof(Chunk) + bytes + alignment;
+        while (next_chunk_bytes_ < required) {
+            next_chunk_bytes_ *= 2;
+        }
+        void* memory = upstream_->allocate(next_chunk_bytes_, alignof(std::max_align_t));
+        Chunk* chunk = new (memory) Chunk{chunks_, next_chunk_bytes_};
+        chunks_ = chunk;
+        current_ = reinterpret_cast<char*>(chunk + 1);
+        end_ = static_cast<char*>(memory) + next_chunk_bytes_;
+        next_chunk_bytes_ *= 2;
+        return allocate(bytes, alignment);
+    }
+
+public:
+    explicit MonotonicArena(std::size_t initial_chunk_bytes = 4096,
+                            std::pmr::memory_resource* upstream = std::pmr::get_default_resource())
+        : upstream_(upstream), chunks_(nullptr), current_(nullptr), end_(nullptr),
+          next_chunk_bytes_(initial_chunk_bytes > sizeof(Chunk) ? initial_chunk_bytes : 2 * sizeof(Chunk)),
+          allocated_bytes_(0) {}
+
+    MonotonicArena(const MonotonicArena&) = delete;
+    MonotonicArena& operator=(const MonotonicArena&) = delete;
+
+    ~MonotonicArena() {
+        release();
+    }
+
+    void* allocate(std::size_t bytes, std::size_t alignment = alignof(std::max_align_t)) {
+        auto address = reinterpret_cast<std::uintptr_t>(current_);
+        auto aligned = (address + alignment - 1) & ~(static_cast<std::uintptr_t>(alignment) - 1);
+        if (current_ == nullptr || aligned + bytes > reinterpret_cast<std::uintptr_t>(end_)) {
+            return allocate_slow(bytes, alignment);
+        }
+        current_ = reinterpret_cast<char*>(aligned + bytes);
+        allocated_bytes_ += bytes;
+        return reinterpret_cast<void*>(aligned);
+    }
+
+    // Память освобождается только вместе со всей ареной
+    void deallocate(void*, std::size_t, std::size_t = alignof(std::max_align_t)) noexcept {}
+
+    // Возвращает все блоки upstream-ресурсу; ранее выделенная память
+    // недействительна. Следующий блок будет размером с наибольший
+    // освобождённый, чтобы повторное заполнение обошлось одним блоком.
+    void release() noexcept {
+        if (chunks_ != nullptr) {
+            next_chunk_bytes_ = chunks_->bytes;
+        }
+        while (chunks_ != nullptr) {
+            Chunk* previous = chunks_->previous;
+            upstream_->deallocate(chunks_, chunks_->bytes, alignof(std::max_align_t));
+            chunks_ = previous;
+        }
+        current_ = end_ = nullptr;
+        allocated_bytes_ = 0;
+    }
+
+    // Сколько байт выдано с момента создания или последнего release()
+    std::size_t allocated_bytes() const noexcept {
+        return allocated_bytes_;
+    }
+};
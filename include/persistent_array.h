@@ -0,0 +1,133 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+
+#include "dynamic_array.h"
+#include "mapped_file_resource.h"
+
+// Сохранение DynamicArray в MappedFileMemoryResource между запусками.
+//
+// PersistentArray<T> выделяет из файла и элементы, и узлы списка.
+// persist_array() упаковывает их compact() в один блок файла (запись
+// "узел + элемент" на элемент, без заголовков блоков ресурса) и
+// регистрирует цепочку в корневой ячейке, а restore_array() после
+// повторного открытия файла подключает ту же цепочку к новому массиву:
+// узлы не перестраиваются, элементы не копируются, память не выделяется.
+//
+// Узлы связаны указателями. Ресурс отображает файл по прежнему адресу,
+// если тот свободен, и тогда restore_array() работает за O(1), не читая
+// ни узлов, ни элементов. Иначе указатели в узлах один раз сдвигаются на
+// месте - O(n) обращений к страницам файла, но по-прежнему без выделений.
+// Поддерживаются тривиально копируемые типы: их представление не содержит
+// указателей, которые стали бы недействительны при другом адресе отображения.
+
+template<typename T>
+using PersistentArray = DynamicArray<T, ResourceAllocation<MappedFileMemoryResource>>;
+
+// Запись в файле: цепочка узлов и адрес начала отображения, для которого
+// записаны указатели в узлах
+struct PersistedArrayImage {
+    std::uint64_t element_size;
+    std::uint64_t element_alignment;
+    std::uint64_t count;
+    std::uint64_t head;          // смещения первого и последнего узлов
+    std::uint64_t tail;
+    std::uint64_t mapped_base;
+};
+
+struct PersistentArrayAccess {
+    // Адрес начала отображения file по указателю внутри него
+    static std::uintptr_t mapped_base(const MappedFileMemoryResource& file, const void* ptr) {
+        return reinterpret_cast<std::uintptr_t>(ptr) - file.offset_of(ptr);
+    }
+
+    // ptr, сдвинутый на delta байт; nullptr остаётся nullptr
+    template<typename Pointee>
+    static Pointee* shifted(Pointee* ptr, std::uintptr_t delta) {
+        if (ptr == nullptr) {
+            return ptr;
+        }
+        return reinterpret_cast<Pointee*>(reinterpret_cast<std::uintptr_t>(ptr) + delta);
+    }
+
+    // Переносит цепочку узлов массива в image; массив становится пустым
+
+    template<typename T>
+    static void store(PersistentArray<T>& array, const MappedFileMemoryResource& file,
+                      PersistedArrayImage& image) {
+        image.count = array.size_;
+        image.head = file.offset_of(array.before_head_.next);
+        image.tail = file.offset_of(array.tail_);
+        array.before_head_.next = array.tail_ = nullptr;
+        array.size_ = 0;
+    }
+
+    // Подключает цепочку из image к пустому массиву. Если файл отображён
+    // по другому адресу, указатели в узлах сдвигаются на разницу адресов.
+    template<typename T>
+    static void load(PersistentArray<T>& array, const MappedFileMemoryResource& file,
+                     PersistedArrayImage& image) {
+        using Node = typename PersistentArray<T>::Node;
+        auto* head = std::launder(static_cast<Node*>(file.pointer_at(image.head)));
+        std::uintptr_t base = mapped_base(file, &image);
+        if (base != image.mapped_base) {
+            std::uintptr_t delta = base - image.mapped_base;
+            for (Node* node = head; node != nullptr; node = node->next) {
+                node->data = std::launder(shifted(node->data, delta));
+                node->next = shifted(node->next, delta);
+                node->slab = shifted(node->slab, delta);
+            }
+            image.mapped_base = base;
+        }
+        array.before_head_.next = head;
+        array.tail_ = std::launder(static_cast<Node*>(file.pointer_at(image.tail)));
+        array.size_ = static_cast<std::size_t>(image.count);
+    }
+};
+
+// Передаёт элементы и узлы array файлу и сохраняет цепочку в ячейке root;
+// массив становится пустым. Массив должен выделять память из file.
+template<typename T>
+void persist_array(MappedFileMemoryResource& file, std::size_t root, PersistentArray<T>&& array) {
+    static_assert(std::is_trivially_copyable_v<T>,
+                  "only trivially copyable elements can be persisted");
+    if (array.get_allocator().resource() != &file) {
+        throw std::invalid_argument("DynamicArray does not allocate from this MappedFileMemoryResource");
+    }
+    if (file.root(root) != nullptr) {
+        throw std::runtime_error("Root slot already holds a persisted array");
+    }
+
+    array.compact();
+    void* memory = file.allocate(sizeof(PersistedArrayImage), alignof(PersistedArrayImage));
+    auto* image = new (memory) PersistedArrayImage{
+        sizeof(T), alignof(T), 0, 0, 0, PersistentArrayAccess::mapped_base(file, memory)};
+    PersistentArrayAccess::store(array, file, *image);
+    file.set_root(root, image);
+}
+
+// Восстанавливает массив, сохранённый persist_array() в ячейке root, и
+// освобождает ячейку: узлы и элементы снова принадлежат массиву. Для
+// пустой ячейки возвращает пустой массив.
+template<typename T>
+PersistentArray<T> restore_array(MappedFileMemoryResource& file, std::size_t root) {
+    static_assert(std::is_trivially_copyable_v<T>,
+                  "only trivially copyable elements can be persisted");
+    PersistentArray<T> array{ResourceAllocator<T, MappedFileMemoryResource>(&file)};
+    auto* image = static_cast<PersistedArrayImage*>(file.root(root));
+    if (image == nullptr) {
+        return array;
+    }
+    if (image->element_size != sizeof(T) || image->element_alignment != alignof(T)) {
+        throw std::runtime_error("Persisted array element type mismatch");
+    }
+
+    PersistentArrayAccess::load(array, file, *image);
+    file.set_root(root, nullptr);
+    file.deallocate(image, sizeof(PersistedArrayImage), alignof(PersistedArrayImage));
+    return array;
+}
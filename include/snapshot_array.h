@@ -0,0 +1,368 @@
+#pragma once
+
+#include <memory_resource>
+#include <atomic>
+#include <memory>
+#include <iterator>
+#include <stdexcept>
+#include <utility>
+#include <cstdint>
+
+#include "epoch_domain.h"
+
+// Односвязный список для одного писателя и многих читателей.
+//
+// Писатель (единственный поток, вызывающий изменяющие методы) добавляет
+// элементы в конец и удаляет их из начала; читатели из любых потоков без
+// блокировок берут snapshot() - фиксированную пару "первый элемент,
+// последний элемент" - и обходят её, пока писатель продолжает работу.
+// Удалённые узлы не уничтожаются сразу, а передаются EpochDomain и
+// освобождаются, когда их не может видеть ни один снимок.
+//
+// Изменяются только голова и хвост списка (атомарные указатели), уже
+// опубликованные узлы и элементы писатель не трогает: новый узел полностью
+// строится до публикации хвоста, а снимок никогда не читает next своего
+// последнего узла, который писатель в это время может заполнять.
+// Поэтому pop_back и вставки в середину не поддерживаются.
+template<typename T>
+class SnapshotArray {
+private:
+    struct Node {
+        T* data;
+        Node* next;
+        std::uint64_t sequence;   // порядковый номер добавления, не убывает вдоль списка
+
+        Node(T* d, std::uint64_t s) : data(d), next(nullptr), sequence(s) {}
+    };
+
+    std::atomic<Node*> head_;
+    std::atomic<Node*> tail_;
+    size_t size_;
+    std::uint64_t next_sequence_;
+
+    // Узлы, снятые pop_front(), но ещё не переданные домену: они остаются
+    // связаны друг с другом и с текущей головой
+    Node* popped_head_;
+    size_t popped_count_;
+    size_t retire_batch_;
+
+    std::pmr::polymorphic_allocator<T> allocator_;
+    std::unique_ptr<EpochDomain> own_domain_;
+    EpochDomain* domain_;
+
+public:
+    using value_type = T;
+    using allocator_type = std::pmr::polymorphic_allocator<T>;
+
+    // Неизменяемый снимок массива; пока он жив, его элементы не освобождаются.
+    // Снимок можно обходить в том потоке, где он получен
+    class Snapshot {
+    private:
+        EpochDomain::Guard guard_;
+        Node* first_;
+        size_t size_;
+
+        friend class SnapshotArray;
+
+        Snapshot(EpochDomain::Guard guard, Node* first, size_t size)
+            : guard_(std::move(guard)), first_(first), size_(size) {}
+
+    public:
+        class Iterator {
+        private:
+            Node* current_;
+            size_t remaining_;
+
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = T;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const T*;
+            using reference = const T&;
+
+            Iterator(Node* node = nullptr, size_t remaining = 0)
+                : current_(remaining > 0 ? node : nullptr), remaining_(remaining) {}
+
+            reference operator*() const {
+                return *(current_->data);
+            }
+
+            pointer operator->() const {
+                return current_->data;
+            }
+
+            // next последнего узла снимка не читается: его может писать писатель
+            Iterator& operator++() {
+                if (--remaining_ == 0) {
+                    current_ = nullptr;
+                } else {
+                    current_ = current_->next;
+                }
+                return *this;
+            }
+
+            Iterator operator++(int) {
+                Iterator temp = *this;
+                ++(*this);
+                return temp;
+            }
+
+            bool operator==(const Iterator& other) const {
+                return current_ == other.current_;
+            }
+
+            bool operator!=(const Iterator& other) const {
+                return current_ != other.current_;
+            }
+        };
+
+        Snapshot(Snapshot&&) noexcept = default;
+        Snapshot& operator=(Snapshot&&) noexcept = default;
+
+        size_t size() const {
+            return size_;
+        }
+
+        bool empty() const {
+            return size_ == 0;
+        }
+
+        Iterator begin() const {
+            return Iterator(first_, size_);
+        }
+
+        Iterator end() const {
+            return Iterator();
+        }
+
+        // Досрочно отпускает снимок; после этого обходить его нельзя
+        void release() {
+            guard_.release();
+            first_ = nullptr;
+            size_ = 0;
+        }
+    };
+
+    // Массив со своим доменом эпох
+    explicit SnapshotArray(const allocator_type& alloc = {})
+        : SnapshotArray(nullptr, alloc) {}
+
+    // Массив, разделяющий домен с другими структурами; domain должен пережить массив
+    explicit SnapshotArray(EpochDomain& domain, const allocator_type& alloc = {})
+        : SnapshotArray(&domain, alloc) {}
+
+    SnapshotArray(const SnapshotArray&) = delete;
+    SnapshotArray& operator=(const SnapshotArray&) = delete;
+
+    // К моменту уничтожения снимков массива быть не должно
+    ~SnapshotArray() {
+        Node* chain = popped_head_ != nullptr ? popped_head_ : head_.load(std::memory_order_relaxed);
+        RetiredChain::destroy(allocator_, chain, popped_count_ + size_);
+    }
+
+    // ==================== Методы писателя ====================
+
+    void push_back(const T& value) {
+        emplace_back(value);
+    }
+
+    void push_back(T&& value) {
+        emplace_back(std::move(value));
+    }
+
+    // Ссылка константная: опубликованный элемент уже могут читать другие потоки
+    template<typename... Args>
+    const T& emplace_back(Args&&... args) {
+        Node* new_node = create_node(std::forward<Args>(args)...);
+        Node* tail = tail_.load(std::memory_order_relaxed);
+        if (tail == nullptr) {
+            head_.store(new_node, std::memory_order_release);
+        } else {
+            tail->next = new_node;
+        }
+        // Публикация: всё, что записано в узел и в next прежнего хвоста,
+        // видно читателю, прочитавшему новый хвост
+        tail_.store(new_node, std::memory_order_release);
+        size_++;
+        return *(new_node->data);
+    }
+
+    // Снимает первый элемент; его память освобождается позже, когда элемент
+    // не будет виден ни одному снимку
+    void pop_front() {
+        Node* head = head_.load(std::memory_order_relaxed);
+        if (head == nullptr) {
+            throw std::out_of_range("SnapshotArray is empty");
+        }
+
+        Node* next = head != tail_.load(std::memory_order_relaxed) ? head->next : nullptr;
+        if (next == nullptr) {
+            tail_.store(nullptr, std::memory_order_release);
+        }
+        head_.store(next, std::memory_order_release);
+        if (popped_head_ == nullptr) {
+            popped_head_ = head;
+        }
+        popped_count_++;
+        size_--;
+
+        // Опустевший список больше не связан со снятыми узлами, поэтому они
+        // передаются домену сразу, до появления новой головы
+        if (next == nullptr || popped_count_ >= retire_batch_) {
+            retire_popped();
+        }
+    }
+
+    // Отсоединяет все элементы и передаёт их домену одной цепочкой
+    void clear() {
+        Node* head = head_.load(std::memory_order_relaxed);
+        if (head == nullptr && popped_head_ == nullptr) {
+            return;
+        }
+        tail_.store(nullptr, std::memory_order_release);
+        head_.store(nullptr, std::memory_order_release);
+
+        // Снятые узлы связаны с текущей головой, поэтому всё уходит одним заданием
+        Node* chain = popped_head_ != nullptr ? popped_head_ : head;
+        size_t count = popped_count_ + size_;
+        popped_head_ = nullptr;
+        popped_count_ = 0;
+        size_ = 0;
+        domain_->retire(std::make_unique<RetiredChain>(chain, count, allocator_));
+    }
+
+    // Передаёт домену снятые узлы и освобождает всё, что уже не видно
+    // читателям; возвращает число освобождённых заданий домена
+    size_t collect() {
+        retire_popped();
+        return domain_->reclaim();
+    }
+
+    // Сколько pop_front() накапливается перед передачей узлов домену
+    void set_retire_batch(size_t batch) {
+        retire_batch_ = batch > 0 ? batch : 1;
+    }
+
+    size_t retire_batch() const {
+        return retire_batch_;
+    }
+
+    // Размер и крайние элементы с точки зрения писателя
+    size_t size() const {
+        return size_;
+    }
+
+    bool empty() const {
+        return size_ == 0;
+    }
+
+    const T& front() const {
+        Node* head = head_.load(std::memory_order_relaxed);
+        if (head == nullptr) {
+            throw std::out_of_range("SnapshotArray is empty");
+        }
+        return *(head->data);
+    }
+
+    const T& back() const {
+        Node* tail = tail_.load(std::memory_order_relaxed);
+        if (tail == nullptr) {
+            throw std::out_of_range("SnapshotArray is empty");
+        }
+        return *(tail->data);
+    }
+
+    // ==================== Методы читателей ====================
+
+    // Закрепляет эпоху и фиксирует текущие первый и последний элементы.
+    // Хвост перечитывается, пока не совпадёт до и после чтения головы: так
+    // пара относится к одному моменту и голова не может оказаться за хвостом.
+    Snapshot snapshot() const {
+        EpochDomain::Guard guard = domain_->pin();
+        for (;;) {
+            Node* tail = tail_.load(std::memory_order_acquire);
+            Node* head = head_.load(std::memory_order_acquire);
+            if (tail_.load(std::memory_order_acquire) != tail) {
+                continue;
+            }
+            if (head == nullptr || tail == nullptr) {
+                return Snapshot(std::move(guard), nullptr, 0);
+            }
+            size_t size = static_cast<size_t>(tail->sequence - head->sequence) + 1;
+            return Snapshot(std::move(guard), head, size);
+        }
+    }
+
+    EpochDomain& domain() const {
+        return *domain_;
+    }
+
+    allocator_type get_allocator() const {
+        return allocator_;
+    }
+
+private:
+    SnapshotArray(EpochDomain* domain, const allocator_type& alloc)
+        : head_(nullptr), tail_(nullptr), size_(0), next_sequence_(0),
+          popped_head_(nullptr), popped_count_(0), retire_batch_(64),
+          allocator_(alloc),
+          own_domain_(domain == nullptr ? std::make_unique<EpochDomain>() : nullptr),
+          domain_(domain == nullptr ? own_domain_.get() : domain) {}
+
+    template<typename... Args>
+    Node* create_node(Args&&... args) {
+        T* new_data = allocator_.allocate(1);
+        try {
+            std::allocator_traits<allocator_type>::construct(
+                allocator_, new_data, std::forward<Args>(args)...);
+        } catch (...) {
+            allocator_.deallocate(new_data, 1);
+            throw;
+        }
+        return new Node(new_data, next_sequence_++);
+    }
+
+    // count узлов, начиная с first; next последнего может указывать на
+    // живые узлы и не разыменовывается
+    class RetiredChain : public ReclaimJob {
+    private:
+        Node* first_;
+        size_t count_;
+        allocator_type allocator_;
+
+    public:
+        RetiredChain(Node* first, size_t count, const allocator_type& allocator)
+            : first_(first), count_(count), allocator_(allocator) {}
+
+        ~RetiredChain() override {
+            destroy(allocator_, first_, count_);
+        }
+
+        bool run(std::size_t max_items) override {
+            size_t batch = count_ < max_items ? count_ : max_items;
+            destroy(allocator_, first_, batch);
+            count_ -= batch;
+            return count_ == 0;
+        }
+
+        // Уничтожает count узлов; first сдвигается на первый неуничтоженный
+        static void destroy(allocator_type& allocator, Node*& first, size_t count) {
+            while (count-- > 0) {
+                Node* next = count > 0 ? first->next : nullptr;
+                std::allocator_traits<allocator_type>::destroy(allocator, first->data);
+                allocator.deallocate(first->data, 1);
+                delete first;
+                first = next;
+            }
+        }
+    };
+
+    void retire_popped() {
+        if (popped_head_ == nullptr) {
+            return;
+        }
+        domain_->retire(std::make_unique<RetiredChain>(popped_head_, popped_count_, allocator_));
+        popped_head_ = nullptr;
+        popped_count_ = 0;
+    }
+};
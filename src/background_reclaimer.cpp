@@ -0,0 +1,70 @@
+#include "../include/background_reclaimer.h"
+
+BackgroundReclaimer::BackgroundReclaimer(std::size_t batch_size)
+    : batch_size_(batch_size > 0 ? batch_size : 1), running_(0), stopping_(false),
+      worker_(&BackgroundReclaimer::worker_loop, this) {}
+
+BackgroundReclaimer::~BackgroundReclaimer() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    work_available_.notify_one();
+    worker_.join();
+}
+
+void BackgroundReclaimer::submit(std::unique_ptr<ReclaimJob> job) {
+    if (!job) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        jobs_.push_back(std::move(job));
+    }
+    work_available_.notify_one();
+}
+
+void BackgroundReclaimer::drain() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    idle_.wait(lock, [this] { return jobs_.empty() && running_ == 0; });
+}
+
+std::size_t BackgroundReclaimer::pending() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return jobs_.size() + running_;
+}
+
+std::size_t BackgroundReclaimer::batch_size() const {
+    return batch_size_;
+}
+
+void BackgroundReclaimer::worker_loop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+        work_available_.wait(lock, [this] { return stopping_ || !jobs_.empty(); });
+        if (jobs_.empty()) {
+            // Остановка только после того, как очередь опустела
+            return;
+        }
+
+        std::unique_ptr<ReclaimJob> job = std::move(jobs_.front());
+        jobs_.pop_front();
+        running_++;
+        lock.unlock();
+
+        bool done = job->run(batch_size_);
+        if (done) {
+            job.reset();
+        }
+
+        lock.lock();
+        running_--;
+        if (!done) {
+            // Незавершённое задание уходит в конец очереди
+            jobs_.push_back(std::move(job));
+        }
+        if (jobs_.empty() && running_ == 0) {
+            idle_.notify_all();
+        }
+    }
+}
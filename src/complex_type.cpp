@@ -1,10 +1,27 @@
 #include "../include/complex_type.h"
 
-ComplexType::ComplexType(int i, std::string n, double v) 
-    : id(i), name(std::move(n)), value(v), data({i, i*2, i*3}) {}
+std::atomic<bool> ComplexType::logging_{true};
 
-ComplexType::ComplexType(const ComplexType& other) 
-    : id(other.id), name(other.name), value(other.value), data(other.data) {}
+ComplexType::ComplexType(int i, std::string_view n, double v, const allocator_type& alloc) 
+    : id(i), name(n, alloc), value(v), data({i, i*2, i*3}, alloc) {}
+
+ComplexType::ComplexType(const allocator_type& alloc)
+    : ComplexType(0, {}, 0.0, alloc) {}
+
+ComplexType::ComplexType(std::allocator_arg_t, const allocator_type& alloc,
+                         int i, std::string_view n, double v)
+    : ComplexType(i, n, v, alloc) {}
+
+ComplexType::ComplexType(const ComplexType& other, const allocator_type& alloc) 
+    : id(other.id), name(other.name, alloc), value(other.value), data(other.data, alloc) {}
+
+ComplexType::ComplexType(ComplexType&& other) noexcept
+    : id(other.id), name(std::move(other.name)), value(other.value), 
+      data(std::move(other.data)) {}
+
+ComplexType::ComplexType(ComplexType&& other, const allocator_type& alloc)
+    : id(other.id), name(std::move(other.name), alloc), value(other.value), 
+      data(std::move(other.data), alloc) {}
 
 ComplexType& ComplexType::operator=(const ComplexType& other) {
     if (this != &other) {
@@ -16,8 +33,31 @@ ComplexType& ComplexType::operator=(const ComplexType& other) {
     return *this;
 }
 
+ComplexType& ComplexType::operator=(ComplexType&& other) {
+    if (this != &other) {
+        id = other.id;
+        name = std::move(other.name);
+        value = other.value;
+        data = std::move(other.data);
+    }
+    return *this;
+}
+
 ComplexType::~ComplexType() {
-    std::cout << "Destroying ComplexType: " << id << " - " << name << std::endl;
+    if (logging_) {
+        std::cout << "Destroying ComplexType: " << id << " - " << name << std::endl;
+    }
+}
+
+ComplexType::allocator_type ComplexType::get_allocator() const {
+    return name.get_allocator();
+}
+
+void ComplexType::reassign(int i, std::string_view n, double v) {
+    id = i;
+    name.assign(n.data(), n.size());
+    value = v;
+    data.assign({i, i*2, i*3});
 }
 
 void ComplexType::print() const {
@@ -30,4 +70,8 @@ void ComplexType::print() const {
         if (i < data.size() - 1) std::cout << ", ";
     }
     std::cout << "] }" << std::endl;
+}
+
+void ComplexType::set_logging(bool enabled) {
+    logging_ = enabled;
 }
\ No newline at end of file
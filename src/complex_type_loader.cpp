@@ -0,0 +1,249 @@
+#include "../include/complex_type_loader.h"
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+// Разобранная запись; name указывает в буфер чтения и живёт до следующего блока
+struct RawRecord {
+    int id = 0;
+    std::string_view name;
+    double value = 0.0;
+    bool has_data = false;
+    std::vector<int> data;
+};
+
+template<typename Number>
+bool parse_number(std::string_view field, Number& result) {
+    const char* first = field.data();
+    const char* last = field.data() + field.size();
+    auto [ptr, ec] = std::from_chars(first, last, result);
+    return ec == std::errc() && ptr == last;
+}
+
+// Разбирает одну строку CSV без завершающего '\n'
+void parse_csv_line(std::string_view line, std::size_t line_number, RawRecord& record) {
+    auto fail = [line_number]() {
+        throw std::runtime_error("Malformed CSV record at line " + std::to_string(line_number));
+    };
+
+    auto next_field = [&line](std::string_view& field) {
+        std::size_t comma = line.find(',');
+        field = line.substr(0, comma);
+        line = comma == std::string_view::npos ? std::string_view() : line.substr(comma + 1);
+        return comma != std::string_view::npos;
+    };
+
+    std::string_view field;
+    if (!next_field(field) || !parse_number(field, record.id)) {
+        fail();
+    }
+    if (!next_field(record.name)) {
+        fail();
+    }
+    bool more = next_field(field);
+    if (!parse_number(field, record.value)) {
+        fail();
+    }
+
+    record.data.clear();
+    record.has_data = more;
+    while (more) {
+        more = next_field(field);
+        int item = 0;
+        if (!parse_number(field, item)) {
+            fail();
+        }
+        record.data.push_back(item);
+    }
+}
+
+template<typename Value>
+bool read_binary(const char*& pos, const char* end, Value& result) {
+    if (static_cast<std::size_t>(end - pos) < sizeof(Value)) {
+        return false;
+    }
+    std::memcpy(&result, pos, sizeof(Value));
+    pos += sizeof(Value);
+    return true;
+}
+
+// Разбирает одну двоичную запись; возвращает false, если запись ещё не
+// дочитана целиком
+bool parse_binary_record(const char*& pos, const char* end, RawRecord& record) {
+    const char* cursor = pos;
+    std::int32_t id = 0;
+    std::uint32_t name_length = 0;
+    std::uint32_t data_count = 0;
+
+    if (!read_binary(cursor, end, id) || !read_binary(cursor, end, name_length)) {
+        return false;
+    }
+    if (static_cast<std::size_t>(end - cursor) < name_length) {
+        return false;
+    }
+    std::string_view name(cursor, name_length);
+    cursor += name_length;
+    if (!read_binary(cursor, end, record.value) || !read_binary(cursor, end, data_count)) {
+        return false;
+    }
+    if (static_cast<std::size_t>(end - cursor) / sizeof(std::int32_t) < data_count) {
+        return false;
+    }
+
+    record.id = id;
+    record.name = name;
+    record.has_data = true;
+    record.data.resize(data_count);
+    for (std::uint32_t i = 0; i < data_count; ++i) {
+        std::int32_t item = 0;
+        read_binary(cursor, end, item);
+        record.data[i] = item;
+    }
+    pos = cursor;
+    return true;
+}
+
+// Читает поток блоками и вызывает on_record для каждой записи.
+// Незавершённый хвост блока переносится в начало буфера; буфер растёт, только
+// если одна запись не помещается в него целиком.
+template<typename OnRecord>
+LoadStats parse_stream(std::istream& in, ComplexTypeLoader::Format format,
+                       std::size_t block_size, OnRecord&& on_record) {
+    auto start = std::chrono::steady_clock::now();
+    LoadStats stats;
+    std::vector<char> buffer(block_size > 0 ? block_size : 1);
+    std::size_t filled = 0;
+    std::size_t line_number = 0;
+    RawRecord record;
+    bool eof = false;
+
+    while (!eof) {
+        if (filled == buffer.size()) {
+            buffer.resize(buffer.size() * 2);
+        }
+        in.read(buffer.data() + filled, static_cast<std::streamsize>(buffer.size() - filled));
+        std::size_t got = static_cast<std::size_t>(in.gcount());
+        stats.bytes += got;
+        filled += got;
+        eof = got == 0 || !in;
+
+        const char* pos = buffer.data();
+        const char* end = buffer.data() + filled;
+
+        if (format == ComplexTypeLoader::Format::Csv) {
+            while (pos < end) {
+                const char* newline = static_cast<const char*>(std::memchr(pos, '\n', end - pos));
+                if (newline == nullptr && !eof) {
+                    break;
+                }
+                const char* line_end = newline != nullptr ? newline : end;
+                std::string_view line(pos, line_end - pos);
+                pos = newline != nullptr ? newline + 1 : end;
+                ++line_number;
+
+                if (!line.empty() && line.back() == '\r') {
+                    line.remove_suffix(1);
+                }
+                if (line.empty()) {
+                    continue;
+                }
+                parse_csv_line(line, line_number, record);
+                on_record(record);
+                ++stats.records;
+            }
+        } else {
+            while (pos < end && parse_binary_record(pos, end, record)) {
+                on_record(record);
+                ++stats.records;
+            }
+            if (eof && pos < end) {
+                throw std::runtime_error("Truncated binary record at end of stream");
+            }
+        }
+
+        filled = static_cast<std::size_t>(end - pos);
+        std::memmove(buffer.data(), pos, filled);
+    }
+
+    stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return stats;
+}
+
+// Создаёт запись прямо в памяти массива
+void append_record(DynamicArray<ComplexType>& out, const RawRecord& record) {
+    ComplexType& item = out.emplace_back(record.id, record.name, record.value);
+    if (record.has_data) {
+        item.data.assign(record.data.begin(), record.data.end());
+    }
+}
+
+} // namespace
+
+double LoadStats::records_per_second() const {
+    return seconds > 0.0 ? static_cast<double>(records) / seconds : 0.0;
+}
+
+double LoadStats::megabytes_per_second() const {
+    return seconds > 0.0 ? static_cast<double>(bytes) / (1024.0 * 1024.0) / seconds : 0.0;
+}
+
+ComplexTypeLoader::ComplexTypeLoader(Format format, std::size_t block_size, std::size_t batch_size)
+    : format_(format), block_size_(block_size), batch_size_(batch_size > 0 ? batch_size : 1) {}
+
+LoadStats ComplexTypeLoader::load(std::istream& in, DynamicArray<ComplexType>& out) const {
+    return parse_stream(in, format_, block_size_, [&out](const RawRecord& record) {
+        append_record(out, record);
+    });
+}
+
+LoadStats ComplexTypeLoader::load_batches(std::istream& in, const BatchHandler& on_batch,
+                                          std::pmr::polymorphic_allocator<ComplexType> alloc) const {
+    DynamicArray<ComplexType> batch(alloc);
+    LoadStats stats = parse_stream(in, format_, block_size_, [&](const RawRecord& record) {
+        append_record(batch, record);
+        if (batch.size() >= batch_size_) {
+            on_batch(batch);
+            batch.clear();
+        }
+    });
+    if (!batch.empty()) {
+        on_batch(batch);
+        batch.clear();
+    }
+    return stats;
+}
+
+ComplexTypeLoader::Format ComplexTypeLoader::format() const {
+    return format_;
+}
+
+std::size_t ComplexTypeLoader::block_size() const {
+    return block_size_;
+}
+
+std::size_t ComplexTypeLoader::batch_size() const {
+    return batch_size_;
+}
+
+void write_binary_record(std::ostream& out, const ComplexType& item) {
+    auto write = [&out](const auto& value) {
+        out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+    };
+    write(static_cast<std::int32_t>(item.id));
+    write(static_cast<std::uint32_t>(item.name.size()));
+    out.write(item.name.data(), static_cast<std::streamsize>(item.name.size()));
+    write(item.value);
+    write(static_cast<std::uint32_t>(item.data.size()));
+    for (int element : item.data) {
+        write(static_cast<std::int32_t>(element));
+    }
+}
@@ -0,0 +1,91 @@
+#include "../include/counting_memory_resource.h"
+#include <new>
+#include <stdexcept>
+
+std::size_t CountingMemoryResource::Counters::live_blocks() const {
+    return allocations - deallocations;
+}
+
+std::size_t CountingMemoryResource::Counters::live_bytes() const {
+    return bytes_allocated - bytes_deallocated;
+}
+
+CountingMemoryResource::Counters
+CountingMemoryResource::Counters::operator-(const Counters& earlier) const {
+    Counters delta;
+    delta.allocations = allocations - earlier.allocations;
+    delta.deallocations = deallocations - earlier.deallocations;
+    delta.bytes_allocated = bytes_allocated - earlier.bytes_allocated;
+    delta.bytes_deallocated = bytes_deallocated - earlier.bytes_deallocated;
+    return delta;
+}
+
+CountingMemoryResource::CountingMemoryResource(std::pmr::memory_resource* upstream)
+    : upstream_(upstream), peak_bytes_(0), budget_(unlimited) {}
+
+void* CountingMemoryResource::do_allocate(std::size_t bytes, std::size_t alignment) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (budget_ == 0) {
+        throw std::bad_alloc();
+    }
+    void* ptr = upstream_->allocate(bytes, alignment);
+    if (budget_ != unlimited) {
+        budget_--;
+    }
+    counters_.allocations++;
+    counters_.bytes_allocated += bytes;
+    if (counters_.live_bytes() > peak_bytes_) {
+        peak_bytes_ = counters_.live_bytes();
+    }
+    return ptr;
+}
+
+void CountingMemoryResource::do_deallocate(void* ptr, std::size_t bytes, std::size_t alignment) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (counters_.live_blocks() == 0 || bytes > counters_.live_bytes()) {
+        throw std::runtime_error("Trying to deallocate unallocated block");
+    }
+    upstream_->deallocate(ptr, bytes, alignment);
+    counters_.deallocations++;
+    counters_.bytes_deallocated += bytes;
+}
+
+bool CountingMemoryResource::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+    return this == &other;
+}
+
+CountingMemoryResource::Counters CountingMemoryResource::counters() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return counters_;
+}
+
+std::size_t CountingMemoryResource::allocations() const {
+    return counters().allocations;
+}
+
+std::size_t CountingMemoryResource::deallocations() const {
+    return counters().deallocations;
+}
+
+std::size_t CountingMemoryResource::live_blocks() const {
+    return counters().live_blocks();
+}
+
+std::size_t CountingMemoryResource::live_bytes() const {
+    return counters().live_bytes();
+}
+
+std::size_t CountingMemoryResource::peak_bytes() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return peak_bytes_;
+}
+
+void CountingMemoryResource::set_allocation_budget(std::size_t count) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    budget_ = count;
+}
+
+std::size_t CountingMemoryResource::allocation_budget() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return budget_;
+}
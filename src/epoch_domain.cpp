@@ -0,0 +1,140 @@
+#include "../include/epoch_domain.h"
+#include <functional>
+#include <limits>
+#include <thread>
+
+EpochDomain::Guard& EpochDomain::Guard::operator=(Guard&& other) noexcept {
+    if (this != &other) {
+        release();
+        slot_ = other.slot_;
+        other.slot_ = nullptr;
+    }
+    return *this;
+}
+
+EpochDomain::Guard::~Guard() {
+    release();
+}
+
+void EpochDomain::Guard::release() {
+    if (slot_ == nullptr) {
+        return;
+    }
+    // release: все чтения читателя упорядочены до того, как писатель увидит
+    // слот свободным и освободит данные
+    slot_->epoch.store(idle_epoch, std::memory_order_release);
+    slot_->in_use.store(false, std::memory_order_release);
+    slot_ = nullptr;
+}
+
+EpochDomain::EpochDomain(std::size_t reader_slots, std::size_t reclaim_threshold)
+    : slots_(new ReaderSlot[reader_slots > 0 ? reader_slots : 1]),
+      slot_count_(reader_slots > 0 ? reader_slots : 1),
+      global_epoch_(idle_epoch + 1),
+      reclaim_threshold_(reclaim_threshold > 0 ? reclaim_threshold : 1),
+      reclaimer_(nullptr) {}
+
+EpochDomain::~EpochDomain() {
+    std::lock_guard<std::mutex> lock(retired_mutex_);
+    for (auto& retired : retired_) {
+        while (!retired.job->run(std::numeric_limits<std::size_t>::max())) {
+        }
+    }
+    retired_.clear();
+}
+
+EpochDomain::ReaderSlot* EpochDomain::acquire_slot() {
+    // Поиск начинается с позиции, зависящей от потока, чтобы читатели
+    // разных потоков обычно не соперничали за один слот
+    std::size_t start = std::hash<std::thread::id>()(std::this_thread::get_id()) % slot_count_;
+    for (;;) {
+        for (std::size_t i = 0; i < slot_count_; ++i) {
+            ReaderSlot& slot = slots_[(start + i) % slot_count_];
+            bool expected = false;
+            if (!slot.in_use.load(std::memory_order_relaxed) &&
+                slot.in_use.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+                return &slot;
+            }
+        }
+        std::this_thread::yield();
+    }
+}
+
+EpochDomain::Guard EpochDomain::pin() {
+    ReaderSlot* slot = acquire_slot();
+    slot->epoch.store(global_epoch_.load(std::memory_order_acquire), std::memory_order_relaxed);
+    // Парный барьер - в oldest_reader_epoch(): либо писатель увидит эту эпоху,
+    // либо читатель увидит состояние после отсоединения данных
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    return Guard(slot);
+}
+
+std::uint64_t EpochDomain::oldest_reader_epoch() const {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    std::uint64_t oldest = std::numeric_limits<std::uint64_t>::max();
+    for (std::size_t i = 0; i < slot_count_; ++i) {
+        std::uint64_t epoch = slots_[i].epoch.load(std::memory_order_acquire);
+        if (epoch != idle_epoch && epoch < oldest) {
+            oldest = epoch;
+        }
+    }
+    return oldest;
+}
+
+void EpochDomain::retire(std::unique_ptr<ReclaimJob> job) {
+    if (!job) {
+        return;
+    }
+    bool should_reclaim = false;
+    {
+        std::lock_guard<std::mutex> lock(retired_mutex_);
+        // Задание помечается эпохой, в которой данные ещё могли быть видны;
+        // читатели, закрепившиеся позже, видят уже новую эпоху
+        std::uint64_t epoch = global_epoch_.fetch_add(1, std::memory_order_acq_rel);
+        retired_.push_back({epoch, std::move(job)});
+        should_reclaim = retired_.size() >= reclaim_threshold_;
+    }
+    if (should_reclaim) {
+        reclaim();
+    }
+}
+
+std::size_t EpochDomain::reclaim() {
+    std::deque<std::unique_ptr<ReclaimJob>> ready;
+    {
+        std::lock_guard<std::mutex> lock(retired_mutex_);
+        std::uint64_t oldest = oldest_reader_epoch();
+        // Эпохи заданий не убывают, поэтому безопасные лежат в начале очереди
+        while (!retired_.empty() && retired_.front().epoch < oldest) {
+            ready.push_back(std::move(retired_.front().job));
+            retired_.pop_front();
+        }
+    }
+
+    for (auto& job : ready) {
+        if (reclaimer_ != nullptr) {
+            reclaimer_->submit(std::move(job));
+        } else {
+            while (!job->run(std::numeric_limits<std::size_t>::max())) {
+            }
+        }
+    }
+    return ready.size();
+}
+
+std::size_t EpochDomain::retired_count() const {
+    std::lock_guard<std::mutex> lock(retired_mutex_);
+    return retired_.size();
+}
+
+std::uint64_t EpochDomain::epoch() const {
+    return global_epoch_.load(std::memory_order_acquire);
+}
+
+void EpochDomain::set_reclaimer(BackgroundReclaimer* reclaimer) {
+    reclaimer_ = reclaimer;
+}
+
+BackgroundReclaimer* EpochDomain::reclaimer() const {
+    return reclaimer_;
+}
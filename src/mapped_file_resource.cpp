@@ -0,0 +1,316 @@
+#include "../include/mapped_file_resource.h"
+#include <cerrno>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr std::uint64_t file_magic = 0x50414d4d3542414cULL;   // "LAB5MMAP"
+constexpr std::uint64_t file_version = 2;
+
+constexpr std::size_t page_size = 4096;
+constexpr unsigned min_class_bits = 4;                       // наименьший блок - 16 байт
+constexpr std::size_t class_count = 48;
+
+constexpr std::uint32_t block_allocated = 0xA110CA7E;
+constexpr std::uint32_t block_free = 0xF4EEB10C;
+
+// Заголовок блока непосредственно перед выделенной памятью
+struct BlockHeader {
+    std::uint32_t state;
+    std::uint32_t size_class;
+    std::uint64_t next_free;   // смещение следующего свободного блока того же класса
+};
+
+static_assert(sizeof(BlockHeader) == 16, "block header must keep 16-byte alignment");
+
+std::size_t align_up(std::size_t value, std::size_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+unsigned size_class_for(std::size_t bytes) {
+    unsigned bits = min_class_bits;
+    while ((std::size_t(1) << bits) < bytes) {
+        ++bits;
+    }
+    return bits - min_class_bits;
+}
+
+std::size_t class_bytes(unsigned size_class) {
+    return std::size_t(1) << (size_class + min_class_bits);
+}
+
+// Блоки класса выравниваются по своему размеру (но не больше страницы),
+// поэтому любой свободный блок класса подходит под любое допустимое выравнивание
+std::size_t class_alignment(unsigned size_class) {
+    std::size_t bytes = class_bytes(size_class);
+    return bytes < page_size ? bytes : page_size;
+}
+
+std::runtime_error file_error(const std::string& what, const std::string& path) {
+    return std::runtime_error(what + ": " + path + " (" + std::strerror(errno) + ")");
+}
+
+} // namespace
+
+struct MappedFileMemoryResource::FileHeader {
+    std::uint64_t magic;
+    std::uint64_t version;
+    std::uint64_t file_size;
+    std::uint64_t top;         // смещение первого ещё не выделявшегося байта
+    std::uint64_t blocks;
+    std::uint64_t bytes;
+    std::uint64_t free_lists[class_count];
+    std::uint64_t roots[root_count];
+    std::uint64_t base_address;   // адрес отображения при последнем открытии
+};
+
+MappedFileMemoryResource::MappedFileMemoryResource(const std::string& path,
+                                                   std::size_t initial_size,
+                                                   std::size_t max_size)
+    : path_(path), fd_(-1), base_(nullptr), reserved_(align_up(max_size, page_size)), mapped_(0) {
+    fd_ = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+    if (fd_ < 0) {
+        throw file_error("Cannot open mapped file", path);
+    }
+
+    try {
+        struct stat info {};
+        if (::fstat(fd_, &info) != 0) {
+            throw file_error("Cannot stat mapped file", path);
+        }
+        std::size_t size = static_cast<std::size_t>(info.st_size);
+        bool created = size == 0;
+        if (created) {
+            size = align_up(initial_size > sizeof(FileHeader) ? initial_size : sizeof(FileHeader),
+                            page_size);
+            if (::ftruncate(fd_, static_cast<off_t>(size)) != 0) {
+                throw file_error("Cannot resize mapped file", path);
+            }
+        }
+        if (size > reserved_) {
+            throw std::runtime_error("Mapped file is larger than max_size: " + path);
+        }
+
+        // Прежний адрес отображения передаётся ядру как подсказка: если он
+        // свободен, указатели, сохранённые в файле, остаются действительными
+        void* hint = nullptr;
+        if (!created) {
+            FileHeader stored{};
+            if (::pread(fd_, &stored, sizeof(FileHeader), 0) == static_cast<ssize_t>(sizeof(FileHeader)) &&
+                stored.magic == file_magic && stored.version == file_version) {
+                hint = reinterpret_cast<void*>(static_cast<std::uintptr_t>(stored.base_address));
+            }
+        }
+
+        // Резерв адресного пространства под весь будущий рост: файл всегда
+        // отображается с одного и того же адреса, и указатели на уже
+        // выделенные блоки не меняются при росте
+        void* reserved = ::mmap(hint, reserved_, PROT_NONE,
+                                MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+        if (reserved == MAP_FAILED) {
+            throw std::bad_alloc();
+        }
+        base_ = static_cast<char*>(reserved);
+        map_file(size);
+
+        FileHeader* file = header();
+        if (created) {
+            std::memset(file, 0, sizeof(FileHeader));
+            file->magic = file_magic;
+            file->version = file_version;
+            file->file_size = size;
+            file->top = align_up(sizeof(FileHeader), 64);
+        } else if (size < sizeof(FileHeader) || file->magic != file_magic ||
+                   file->version != file_version || file->file_size > size) {
+            throw std::runtime_error("Not a mapped memory resource file: " + path);
+        }
+        file->base_address = reinterpret_cast<std::uintptr_t>(base_);
+
+    } catch (...) {
+        if (base_ != nullptr) {
+            ::munmap(base_, reserved_);
+        }
+        ::close(fd_);
+        throw;
+    }
+}
+
+MappedFileMemoryResource::~MappedFileMemoryResource() {
+    // Изменённые страницы остаются в страничном кэше и записываются ядром;
+    // для гарантированной записи нужно вызвать flush()
+    ::munmap(base_, reserved_);
+    ::close(fd_);
+}
+
+MappedFileMemoryResource::FileHeader* MappedFileMemoryResource::header() const {
+    return reinterpret_cast<FileHeader*>(base_);
+}
+
+void MappedFileMemoryResource::map_file(std::size_t size) {
+    // MAP_FIXED поверх резерва (или прежнего отображения того же файла):
+    // уже отображённые страницы остаются на своих адресах
+    void* mapped = ::mmap(base_, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd_, 0);
+    if (mapped == MAP_FAILED) {
+        throw file_error("Cannot map file", path_);
+    }
+    mapped_ = size;
+}
+
+void MappedFileMemoryResource::grow(std::size_t required) {
+    std::size_t size = mapped_ * 2 > required ? mapped_ * 2 : required;
+    size = align_up(size, page_size);
+    if (size > reserved_) {
+        if (required > reserved_) {
+            throw std::bad_alloc();
+        }
+        size = reserved_;
+    }
+    if (::ftruncate(fd_, static_cast<off_t>(size)) != 0) {
+        throw file_error("Cannot resize mapped file", path_);
+    }
+    map_file(size);
+    header()->file_size = size;
+}
+
+void* MappedFileMemoryResource::do_allocate(std::size_t bytes, std::size_t alignment) {
+    if (alignment > page_size) {
+        throw std::bad_alloc();
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    unsigned size_class = size_class_for(bytes > alignment ? bytes : alignment);
+    if (size_class >= class_count) {
+        throw std::bad_alloc();
+    }
+    FileHeader* file = header();
+
+    std::uint64_t offset = file->free_lists[size_class];
+    if (offset != 0) {
+        auto* block = reinterpret_cast<BlockHeader*>(base_ + offset - sizeof(BlockHeader));
+        file->free_lists[size_class] = block->next_free;
+        block->state = block_allocated;
+        block->next_free = 0;
+    } else {
+        // Новый блок берётся с вершины; промежуток, оставшийся из-за
+        // выравнивания, не используется
+        offset = align_up(file->top + sizeof(BlockHeader), class_alignment(size_class));
+        std::size_t end = offset + class_bytes(size_class);
+        if (end > mapped_) {
+            grow(end);
+            file = header();
+        }
+        auto* block = reinterpret_cast<BlockHeader*>(base_ + offset - sizeof(BlockHeader));
+        block->state = block_allocated;
+        block->size_class = size_class;
+        block->next_free = 0;
+        file->top = end;
+    }
+
+    file->blocks++;
+    file->bytes += class_bytes(size_class);
+    return base_ + offset;
+}
+
+void MappedFileMemoryResource::do_deallocate(void* ptr, std::size_t /*bytes*/, std::size_t /*alignment*/) {
+    if (ptr == nullptr) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    char* address = static_cast<char*>(ptr);
+    FileHeader* file = header();
+    if (address < base_ + sizeof(FileHeader) + sizeof(BlockHeader) || address >= base_ + file->top) {
+        throw std::runtime_error("Trying to deallocate unallocated block");
+    }
+    auto* block = reinterpret_cast<BlockHeader*>(address - sizeof(BlockHeader));
+    if (block->state != block_allocated || block->size_class >= class_count) {
+        throw std::runtime_error("Trying to deallocate unallocated block");
+    }
+
+    block->state = block_free;
+    block->next_free = file->free_lists[block->size_class];
+    file->free_lists[block->size_class] = static_cast<std::uint64_t>(address - base_);
+    file->blocks--;
+    file->bytes -= class_bytes(block->size_class);
+}
+
+bool MappedFileMemoryResource::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+    return this == &other;
+}
+
+void MappedFileMemoryResource::flush() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (::msync(base_, mapped_, MS_SYNC) != 0) {
+        throw file_error("Cannot flush mapped file", path_);
+    }
+}
+
+std::size_t MappedFileMemoryResource::allocated_blocks_count() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return static_cast<std::size_t>(header()->blocks);
+}
+
+std::size_t MappedFileMemoryResource::allocated_bytes() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return static_cast<std::size_t>(header()->bytes);
+}
+
+std::size_t MappedFileMemoryResource::file_size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return mapped_;
+}
+
+const std::string& MappedFileMemoryResource::path() const {
+    return path_;
+}
+
+std::uint64_t MappedFileMemoryResource::offset_of(const void* ptr) const {
+    if (ptr == nullptr) {
+        return 0;
+    }
+    const char* address = static_cast<const char*>(ptr);
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (address < base_ || address >= base_ + mapped_) {
+        throw std::out_of_range("Pointer is outside of the mapped file");
+    }
+    return static_cast<std::uint64_t>(address - base_);
+}
+
+void* MappedFileMemoryResource::pointer_at(std::uint64_t offset) const {
+    if (offset == 0) {
+        return nullptr;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (offset >= mapped_) {
+        throw std::out_of_range("Offset is outside of the mapped file");
+    }
+    return base_ + offset;
+}
+
+void* MappedFileMemoryResource::root(std::size_t index) const {
+    if (index >= root_count) {
+        throw std::out_of_range("Root index out of range");
+    }
+    std::uint64_t offset = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        offset = header()->roots[index];
+    }
+    return pointer_at(offset);
+}
+
+void MappedFileMemoryResource::set_root(std::size_t index, const void* ptr) {
+    if (index >= root_count) {
+        throw std::out_of_range("Root index out of range");
+    }
+    std::uint64_t offset = offset_of(ptr);
+    std::lock_guard<std::mutex> lock(mutex_);
+    header()->roots[index] = offset;
+}
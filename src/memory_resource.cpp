@@ -2,40 +2,151 @@
 #include <iostream>
 #include <stdexcept>
 
-DynamicBlockMemoryResource::BlockInfo::BlockInfo(void* p, std::size_t s) 
-    : ptr(p), size(s) {}
+DynamicBlockMemoryResource::BlockInfo::BlockInfo(void* p, std::size_t s, std::size_t a) 
+    : ptr(p), size(s), alignment(a), stride(0), live_count(1) {}
 
 DynamicBlockMemoryResource::DynamicBlockMemoryResource(
     std::pmr::memory_resource* upstream) 
-    : upstream_(upstream) {}
+    : DynamicBlockMemoryResource(AllocationMode::Packed, upstream) {}
+
+DynamicBlockMemoryResource::DynamicBlockMemoryResource(
+    AllocationMode mode, std::pmr::memory_resource* upstream) 
+    : live_blocks_(0), upstream_(upstream), mode_(mode), logging_(true) {}
+
+void DynamicBlockMemoryResource::adjust_for_mode(std::size_t& bytes, std::size_t& alignment) const {
+    if (mode_ == AllocationMode::CacheLineAligned) {
+        // Дополняем блок до целого числа кэш-линий, чтобы соседние блоки
+        // никогда не делили одну линию
+        bytes = (bytes + cache_line_size - 1) / cache_line_size * cache_line_size;
+        if (alignment < cache_line_size) {
+            alignment = cache_line_size;
+        }
+    }
+}
 
 void* DynamicBlockMemoryResource::do_allocate(std::size_t bytes, std::size_t alignment) {
     if (bytes == 0) {
         return nullptr;
     }
+    std::lock_guard<std::mutex> lock(mutex_);
+    LAB5_MEASURE_LATENCY(latency_.allocate);
+    
+    adjust_for_mode(bytes, alignment);
     
     void* ptr = upstream_->allocate(bytes, alignment);
-    allocated_blocks_.emplace(ptr, BlockInfo{ptr, bytes});
+    allocated_blocks_.emplace(ptr, BlockInfo{ptr, bytes, alignment});
+    live_blocks_++;
     
-    std::cout << "Allocated block: " << ptr << ", size: " << bytes 
-              << ", alignment: " << alignment << std::endl;
+    if (logging_) {
+        std::cout << "Allocated block: " << ptr << ", size: " << bytes 
+                  << ", alignment: " << alignment << std::endl;
+    }
     return ptr;
 }
 
-void DynamicBlockMemoryResource::do_deallocate(void* ptr, std::size_t bytes, std::size_t alignment) {
+void DynamicBlockMemoryResource::do_deallocate(void* ptr, std::size_t bytes, std::size_t /*alignment*/) {
     // Проверяем, что указатель не nullptr (это разрешено стандартом для deallocate)
     if (ptr == nullptr) {
         return;
     }
+    std::lock_guard<std::mutex> lock(mutex_);
+    LAB5_MEASURE_LATENCY(latency_.deallocate);
+    release_block(ptr, bytes, allocated_blocks_.end());
+}
+
+DynamicBlockMemoryResource::BlockMap::iterator
+DynamicBlockMemoryResource::release_block(void* ptr, std::size_t bytes, BlockMap::iterator hint) {
+    auto it = hint;
+    char* address = static_cast<char*>(ptr);
+    if (it == allocated_blocks_.end() || address < static_cast<char*>(it->first) ||
+        address >= static_cast<char*>(it->first) + it->second.size) {
+        // Блок ищется среди записей с адресом не больше ptr: это либо сам
+        // блок, либо область allocate_bulk, внутри которой он лежит
+        it = allocated_blocks_.upper_bound(ptr);
+        if (it == allocated_blocks_.begin()) {
+            throw std::runtime_error("Trying to deallocate unallocated block");
+        }
+        --it;
+    }
+    BlockInfo& info = it->second;
     
-    auto it = allocated_blocks_.find(ptr);
-    if (it != allocated_blocks_.end()) {
-        upstream_->deallocate(ptr, bytes, alignment);
-        allocated_blocks_.erase(it);
-        
-        std::cout << "Deallocated block: " << ptr << ", size: " << bytes << std::endl;
+    if (info.stride == 0) {
+        if (it->first != ptr) {
+            throw std::runtime_error("Trying to deallocate unallocated block");
+        }
     } else {
-        throw std::runtime_error("Trying to deallocate unallocated block");
+        std::size_t offset = static_cast<std::size_t>(address - static_cast<char*>(info.ptr));
+        std::size_t index = offset / info.stride;
+        if (offset >= info.size || offset % info.stride != 0 || !info.live[index]) {
+            throw std::runtime_error("Trying to deallocate unallocated block");
+        }
+        info.live[index] = false;
+    }
+    live_blocks_--;
+    
+    if (logging_) {
+        std::cout << "Deallocated block: " << ptr << ", size: " << bytes << std::endl;
+    }
+    if (--info.live_count == 0) {
+        // Возвращаем upstream реальные размер и выравнивание блока,
+        // они могут отличаться от запрошенных в режиме CacheLineAligned
+        upstream_->deallocate(info.ptr, info.size, info.alignment);
+        allocated_blocks_.erase(it);
+        return allocated_blocks_.end();
+    }
+    return it;
+}
+
+void DynamicBlockMemoryResource::do_allocate_bulk(std::size_t count, std::size_t bytes,
+                                                  std::size_t alignment, void** out) {
+    if (count == 0) {
+        return;
+    }
+    if (bytes == 0) {
+        for (std::size_t i = 0; i < count; ++i) {
+            out[i] = nullptr;
+        }
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    LAB5_MEASURE_LATENCY(latency_.allocate_bulk);
+    
+    adjust_for_mode(bytes, alignment);
+    std::size_t stride = (bytes + alignment - 1) / alignment * alignment;
+    
+    char* region = static_cast<char*>(upstream_->allocate(stride * count, alignment));
+    try {
+        BlockInfo info{region, stride * count, alignment};
+        info.stride = stride;
+        info.live.assign(count, true);
+        info.live_count = count;
+        allocated_blocks_.emplace(region, std::move(info));
+    } catch (...) {
+        upstream_->deallocate(region, stride * count, alignment);
+        throw;
+    }
+    live_blocks_ += count;
+    
+    for (std::size_t i = 0; i < count; ++i) {
+        out[i] = region + i * stride;
+    }
+    if (logging_) {
+        std::cout << "Allocated region: " << static_cast<void*>(region) << ", blocks: " << count
+                  << ", size: " << bytes << ", alignment: " << alignment << std::endl;
+    }
+}
+
+void DynamicBlockMemoryResource::do_deallocate_bulk(std::size_t count, std::size_t bytes,
+                                                    std::size_t /*alignment*/, void* const* ptrs) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    LAB5_MEASURE_LATENCY(latency_.deallocate_bulk);
+    // Соседние блоки пачки обычно лежат в одной области: она проверяется
+    // первой, без поиска по всем записям
+    auto hint = allocated_blocks_.end();
+    for (std::size_t i = 0; i < count; ++i) {
+        if (ptrs[i] != nullptr) {
+            hint = release_block(ptrs[i], bytes, hint);
+        }
     }
 }
 
@@ -45,12 +156,34 @@ bool DynamicBlockMemoryResource::do_is_equal(const std::pmr::memory_resource& ot
 
 DynamicBlockMemoryResource::~DynamicBlockMemoryResource() {
     for (const auto& [ptr, info] : allocated_blocks_) {
-        std::cout << "Cleaning up leaked block: " << ptr << ", size: " << info.size << std::endl;
-        upstream_->deallocate(ptr, info.size);
+        if (logging_) {
+            std::cout << "Cleaning up leaked block: " << ptr << ", size: " << info.size << std::endl;
+        }
+        upstream_->deallocate(ptr, info.size, info.alignment);
     }
     allocated_blocks_.clear();
 }
 
 std::size_t DynamicBlockMemoryResource::allocated_blocks_count() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return live_blocks_;
+}
+
+std::size_t DynamicBlockMemoryResource::upstream_blocks_count() const {
+    std::lock_guard<std::mutex> lock(mutex_);
     return allocated_blocks_.size();
-}
\ No newline at end of file
+}
+
+AllocationMode DynamicBlockMemoryResource::allocation_mode() const {
+    return mode_;
+}
+
+void DynamicBlockMemoryResource::set_logging(bool enabled) {
+    logging_ = enabled;
+}
+
+#ifdef LAB5_LATENCY_HISTOGRAMS
+const MemoryResourceLatency& DynamicBlockMemoryResource::latency_stats() const {
+    return latency_;
+}
+#endif
\ No newline at end of file
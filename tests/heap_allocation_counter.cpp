@@ -0,0 +1,25 @@
+#include "heap_allocation_counter.h"
+#include <cstdlib>
+#include <new>
+
+thread_local HeapAllocationCounter* HeapAllocationCounter::current = nullptr;
+
+void* operator new(std::size_t size) {
+    if (HeapAllocationCounter* counter = HeapAllocationCounter::current) {
+        counter->allocations++;
+        counter->bytes += size;
+    }
+    void* ptr = std::malloc(size != 0 ? size : 1);
+    if (ptr == nullptr) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstddef>
+
+// Счётчик обращений к глобальному operator new в текущем потоке: узлы
+// списка и служебные объекты контейнеров выделяются не через memory_resource.
+// Вложенные счётчики не суммируются - считает самый внутренний.
+// Замена operator new/delete находится в heap_allocation_counter.cpp,
+// отдельной единице трансляции, чтобы компилятор не встраивал её в тесты.
+class HeapAllocationCounter {
+private:
+    HeapAllocationCounter* previous_;
+    
+public:
+    std::size_t allocations = 0;
+    std::size_t bytes = 0;
+    
+    static thread_local HeapAllocationCounter* current;
+    
+    HeapAllocationCounter() : previous_(current) {
+        current = this;
+    }
+    
+    ~HeapAllocationCounter() {
+        current = previous_;
+    }
+    
+    HeapAllocationCounter(const HeapAllocationCounter&) = delete;
+    HeapAllocationCounter& operator=(const HeapAllocationCounter&) = delete;
+};
@@ -4,11 +4,27 @@
 #include <algorithm>
 #include <stdexcept>
 #include <string>
+#include <cstdint>
+#include <sstream>
+#include <atomic>
+#include <thread>
+#include <type_traits>
+#include <iterator>
+#include <cstdio>
+#include <fstream>
 
 
 #include "complex_type.h"
+#include "complex_type_loader.h"
+#include "counting_memory_resource.h"
 #include "dynamic_array.h"
+#include "dynamic_array_views.h"
+#include "heap_allocation_counter.h"
+#include "mapped_file_resource.h"
 #include "memory_resource.h"
+#include "monotonic_arena.h"
+#include "persistent_array.h"
+#include "snapshot_array.h"
 
 // ==================== Тесты для ComplexType ====================
 TEST(ComplexTypeTest, DefaultConstructor) {
@@ -62,6 +78,57 @@ TEST(ComplexTypeTest, AssignmentOperator) {
     EXPECT_EQ(a.data[2], b.data[2]);
 }
 
+TEST(ComplexTypeTest, MoveConstructor) {
+    ComplexType original(7, "A rather long name that does not fit SSO", 1.5);
+    const char* name_buffer = original.name.data();
+    const int* data_buffer = original.data.data();
+    
+    ComplexType moved(std::move(original));
+    EXPECT_EQ(moved.id, 7);
+    EXPECT_EQ(moved.name, "A rather long name that does not fit SSO");
+    // Буферы строки и вектора переданы, а не скопированы
+    EXPECT_EQ(moved.name.data(), name_buffer);
+    EXPECT_EQ(moved.data.data(), data_buffer);
+}
+
+TEST(ComplexTypeTest, AllocatorAwareConstruction) {
+    DynamicBlockMemoryResource resource;
+    resource.set_logging(false);
+    
+    ComplexType ct(1, "A name long enough to need a heap buffer", 1.0, &resource);
+    EXPECT_EQ(ct.get_allocator().resource(), &resource);
+    EXPECT_EQ(ct.data.get_allocator().resource(), &resource);
+    EXPECT_EQ(resource.allocated_blocks_count(), 2);
+    
+    // Копия без аллокатора использует ресурс по умолчанию, с аллокатором - заданный
+    ComplexType default_copy(ct);
+    EXPECT_EQ(default_copy.get_allocator().resource(), std::pmr::get_default_resource());
+    ComplexType resource_copy(ct, &resource);
+    EXPECT_EQ(resource_copy.get_allocator().resource(), &resource);
+    EXPECT_EQ(resource.allocated_blocks_count(), 4);
+}
+
+TEST(ComplexTypeTest, EmplaceWithAnyNumberOfArguments) {
+    DynamicBlockMemoryResource resource;
+    resource.set_logging(false);
+    DynamicArray<ComplexType> array{std::pmr::polymorphic_allocator<ComplexType>(&resource)};
+    
+    array.emplace_back();
+    array.emplace_back(1);
+    array.emplace_back(2, "A name long enough to need a heap buffer");
+    array.emplace_back(3, "Three", 3.0);
+    
+    std::vector<int> ids;
+    for (const auto& item : array) {
+        ids.push_back(item.id);
+        EXPECT_EQ(item.get_allocator().resource(), &resource);
+        EXPECT_EQ(item.data.get_allocator().resource(), &resource);
+    }
+    EXPECT_EQ(ids, (std::vector<int>{0, 1, 2, 3}));
+    EXPECT_EQ(std::next(array.begin(), 2)->name, "A name long enough to need a heap buffer");
+    EXPECT_DOUBLE_EQ(array.begin()->value, 0.0);
+}
+
 TEST(ComplexTypeTest, SelfAssignment) {
     ComplexType a(1, "A", 1.0);
     a.data = {1, 2, 3};
@@ -164,6 +231,26 @@ TEST(DynamicBlockMemoryResourceTest, ExceptionOnInvalidFree) {
     EXPECT_THROW(resource.deallocate(invalid_ptr, 100, 8), std::runtime_error);
 }
 
+TEST(DynamicBlockMemoryResourceTest, CacheLineAlignedMode) {
+    DynamicBlockMemoryResource resource(AllocationMode::CacheLineAligned);
+    resource.set_logging(false);
+    EXPECT_EQ(resource.allocation_mode(), AllocationMode::CacheLineAligned);
+    
+    void* ptr1 = resource.allocate(sizeof(int), alignof(int));
+    void* ptr2 = resource.allocate(sizeof(int), alignof(int));
+    
+    auto addr1 = reinterpret_cast<std::uintptr_t>(ptr1);
+    auto addr2 = reinterpret_cast<std::uintptr_t>(ptr2);
+    EXPECT_EQ(addr1 % cache_line_size, 0u);
+    EXPECT_EQ(addr2 % cache_line_size, 0u);
+    // Блоки не делят одну кэш-линию
+    EXPECT_NE(addr1 / cache_line_size, addr2 / cache_line_size);
+    
+    resource.deallocate(ptr1, sizeof(int), alignof(int));
+    resource.deallocate(ptr2, sizeof(int), alignof(int));
+    EXPECT_EQ(resource.allocated_blocks_count(), 0);
+}
+
 TEST(DynamicBlockMemoryResourceTest, CleanupOnDestruction) {
     {
         DynamicBlockMemoryResource resource;
@@ -176,6 +263,45 @@ TEST(DynamicBlockMemoryResourceTest, CleanupOnDestruction) {
     EXPECT_EQ(resource2.allocated_blocks_count(), 0);
 }
 
+TEST(DynamicBlockMemoryResourceTest, BulkAllocationUsesOneUpstreamRegion) {
+    DynamicBlockMemoryResource resource;
+    resource.set_logging(false);
+    void* blocks[100];
+    resource.allocate_bulk(100, sizeof(int), alignof(int), blocks);
+    EXPECT_EQ(resource.allocated_blocks_count(), 100);
+    EXPECT_EQ(resource.upstream_blocks_count(), 1);
+    for (int i = 1; i < 100; ++i) {
+        EXPECT_EQ(static_cast<char*>(blocks[i]) - static_cast<char*>(blocks[i - 1]),
+                  static_cast<std::ptrdiff_t>(sizeof(int)));
+    }
+    
+    // Блоки области освобождаются и по одному
+    resource.deallocate(blocks[50], sizeof(int), alignof(int));
+    EXPECT_EQ(resource.allocated_blocks_count(), 99);
+    EXPECT_THROW(resource.deallocate(blocks[50], sizeof(int), alignof(int)), std::runtime_error);
+    EXPECT_THROW(resource.deallocate(static_cast<char*>(blocks[10]) + 1, sizeof(int), alignof(int)),
+                 std::runtime_error);
+    
+    blocks[50] = nullptr;
+    resource.deallocate_bulk(100, sizeof(int), alignof(int), blocks);
+    EXPECT_EQ(resource.allocated_blocks_count(), 0);
+    EXPECT_EQ(resource.upstream_blocks_count(), 0);
+}
+
+TEST(DynamicBlockMemoryResourceTest, BulkAllocationRespectsCacheLineMode) {
+    DynamicBlockMemoryResource aligned(AllocationMode::CacheLineAligned);
+    aligned.set_logging(false);
+    void* blocks[4];
+    aligned.allocate_bulk(4, 8, 8, blocks);
+    for (void* block : blocks) {
+        EXPECT_EQ(reinterpret_cast<std::uintptr_t>(block) % cache_line_size, 0u);
+    }
+    EXPECT_EQ(static_cast<char*>(blocks[1]) - static_cast<char*>(blocks[0]),
+              static_cast<std::ptrdiff_t>(cache_line_size));
+    aligned.deallocate_bulk(4, 8, 8, blocks);
+    EXPECT_EQ(aligned.upstream_blocks_count(), 0);
+}
+
 // ==================== Тесты для DynamicArray ====================
 class DynamicArrayTest : public ::testing::Test {
 protected:
@@ -360,6 +486,22 @@ TEST_F(DynamicArrayTest, ConstIterator) {
     EXPECT_EQ(sum, 6);
 }
 
+TEST_F(DynamicArrayTest, ConstIteratorIsConstCorrect) {
+    using Array = DynamicArray<int>;
+    static_assert(std::is_same_v<Array::const_iterator::reference, const int&>);
+    static_assert(std::is_same_v<decltype(*std::declval<const Array&>().begin()), const int&>);
+    static_assert(std::is_convertible_v<Array::iterator, Array::const_iterator>);
+    static_assert(!std::is_convertible_v<Array::const_iterator, Array::iterator>);
+    
+    DynamicArray<int> array({1, 2, 3}, *alloc);
+    DynamicArray<int>::const_iterator it = array.begin();
+    EXPECT_EQ(it, array.begin());
+    EXPECT_EQ(*it, 1);
+    ++it;
+    EXPECT_NE(it, array.end());
+    EXPECT_EQ(*it, 2);
+}
+
 TEST_F(DynamicArrayTest, ComplexTypeInDynamicArray) {
     std::pmr::polymorphic_allocator<ComplexType> complex_alloc(resource);
     DynamicArray<ComplexType> array(complex_alloc);
@@ -391,6 +533,1524 @@ TEST_F(DynamicArrayTest, GetAllocator) {
     EXPECT_EQ(returned_alloc.resource(), alloc->resource());
 }
 
+TEST_F(DynamicArrayTest, CacheLineLayout) {
+    DynamicArray<int, CacheLineLayout> array({1, 2, 3, 4}, *alloc);
+    
+    int expected = 1;
+    for (const auto& item : array) {
+        EXPECT_EQ(item, expected++);
+        EXPECT_EQ(reinterpret_cast<std::uintptr_t>(&item) % cache_line_size, 0u);
+    }
+    
+    array.pop_back();
+    EXPECT_EQ(array.back(), 3);
+    array.clear();
+    EXPECT_EQ(resource->allocated_blocks_count(), 0);
+}
+
+TEST_F(DynamicArrayTest, EmplaceBack) {
+    std::pmr::polymorphic_allocator<ComplexType> complex_alloc(resource);
+    DynamicArray<ComplexType> array(complex_alloc);
+    
+    ComplexType& item = array.emplace_back(5, "Five", 5.5);
+    EXPECT_EQ(&item, &array.back());
+    EXPECT_EQ(item.id, 5);
+    EXPECT_EQ(item.name, "Five");
+    EXPECT_EQ(item.data[2], 15);
+}
+
+template<typename... Policies>
+std::vector<int> to_vector(const DynamicArray<int, Policies...>& array) {
+    return std::vector<int>(array.begin(), array.end());
+}
+
+TEST_F(DynamicArrayTest, CopyAndClearUseBulkAllocation) {
+    resource->set_logging(false);
+    DynamicArray<int> array(*alloc);
+    for (int i = 0; i < 3000; ++i) {
+        array.push_back(i);
+    }
+    EXPECT_EQ(resource->upstream_blocks_count(), 3000);
+    
+    {
+        DynamicArray<int> copy(array);
+        // Пачки по 1024 элемента: три области вместо 3000 блоков
+        EXPECT_EQ(resource->allocated_blocks_count(), 6000);
+        EXPECT_EQ(resource->upstream_blocks_count(), 3003);
+        EXPECT_EQ(to_vector(copy), to_vector(array));
+        
+        copy.pop_front();
+        copy.erase_after(copy.cbegin());
+        std::vector<int> expected = to_vector(array);
+        expected.erase(expected.begin(), expected.begin() + 1);
+        expected.erase(expected.begin() + 1);
+        EXPECT_EQ(to_vector(copy), expected);
+        copy.compact();
+        EXPECT_EQ(to_vector(copy), expected);
+        copy.clear();
+        EXPECT_EQ(resource->upstream_blocks_count(), 3000);
+
+    }
+    array.clear();
+    EXPECT_EQ(resource->allocated_blocks_count(), 0);
+}
+
+TEST_F(DynamicArrayTest, RangeConstructionAndInsertion) {
+    std::vector<int> source{1, 2, 3, 4, 5};
+    DynamicArray<int> array(source.begin(), source.end(), *alloc);
+    EXPECT_EQ(to_vector(array), source);
+    EXPECT_EQ(resource->upstream_blocks_count(), 1);
+    
+    std::vector<int> middle{10, 20};
+    auto last = array.insert_after(array.cbegin(), middle.begin(), middle.end());
+    EXPECT_EQ(*last, 20);
+    EXPECT_EQ(to_vector(array), (std::vector<int>{1, 10, 20, 2, 3, 4, 5}));
+    auto same = array.insert_after(array.cbegin(), middle.end(), middle.end());
+    EXPECT_EQ(same, array.begin());
+    
+    // Однопроходные итераторы и ресурсы без пакетного интерфейса - поэлементно
+    std::istringstream in("7 8 9");
+    DynamicArray<int> parsed{std::istream_iterator<int>(in), std::istream_iterator<int>()};
+    EXPECT_EQ(to_vector(parsed), (std::vector<int>{7, 8, 9}));
+    DynamicArray<int> copy(parsed);
+    EXPECT_EQ(to_vector(copy), (std::vector<int>{7, 8, 9}));
+    
+    array.clear();
+    EXPECT_EQ(resource->allocated_blocks_count(), 0);
+}
+
+// ==================== Тесты для вставки, удаления и splice ====================
+TEST_F(DynamicArrayTest, PushFrontPopFront) {
+    DynamicArray<int> array(*alloc);
+    array.push_front(2);
+    array.push_front(1);
+    array.push_back(3);
+    EXPECT_EQ(to_vector(array), (std::vector<int>{1, 2, 3}));
+    EXPECT_EQ(array.back(), 3);
+    
+    array.pop_front();
+    array.pop_front();
+    EXPECT_EQ(array.front(), 3);
+    EXPECT_EQ(array.back(), 3);
+    array.pop_front();
+    EXPECT_TRUE(array.empty());
+    EXPECT_THROW(array.pop_front(), std::out_of_range);
+    
+    // После опустошения хвост сброшен корректно
+    array.push_back(7);
+    EXPECT_EQ(array.front(), 7);
+    EXPECT_EQ(resource->allocated_blocks_count(), 1);
+}
+
+TEST_F(DynamicArrayTest, InsertAfterEraseAfter) {
+    DynamicArray<int> array({1, 3, 5}, *alloc);
+    
+    auto it = array.insert_after(array.begin(), 2);
+    EXPECT_EQ(*it, 2);
+    array.insert_after(array.before_begin(), 0);
+    
+    auto last = array.begin();
+    while (std::next(last) != array.end()) {
+        ++last;
+    }
+    array.insert_after(last, 6);
+    EXPECT_EQ(array.back(), 6);
+    EXPECT_EQ(to_vector(array), (std::vector<int>{0, 1, 2, 3, 5, 6}));
+    
+    auto after = array.erase_after(std::next(array.begin(), 3));  // удаляет 5
+    EXPECT_EQ(*after, 6);
+    array.erase_after(array.before_begin());                       // удаляет 0
+    array.erase_after(std::next(array.begin(), 2));                // удаляет 6, хвост
+    EXPECT_EQ(to_vector(array), (std::vector<int>{1, 2, 3}));
+    EXPECT_EQ(array.back(), 3);
+    EXPECT_EQ(array.size(), 3);
+    
+    EXPECT_THROW(array.erase_after(std::next(array.begin(), 2)), std::out_of_range);
+    EXPECT_THROW(array.insert_after(array.end(), 4), std::out_of_range);
+}
+
+TEST_F(DynamicArrayTest, SpliceWholeArrayWithoutCopies) {
+    DynamicArray<int> array({1, 4}, *alloc);
+    DynamicArray<int> other({2, 3}, *alloc);
+    const int* element = &other.front();
+    
+    array.splice_after(array.begin(), other);
+    EXPECT_EQ(to_vector(array), (std::vector<int>{1, 2, 3, 4}));
+    EXPECT_TRUE(other.empty());
+    // Узлы перевешены, элемент остался на месте
+    EXPECT_EQ(&*std::next(array.begin()), element);
+    EXPECT_EQ(resource->allocated_blocks_count(), 4);
+    
+    DynamicArray<int> tail({5, 6}, *alloc);
+    auto last = std::next(array.begin(), 3);
+    array.splice_after(last, tail);
+    EXPECT_EQ(array.back(), 6);
+    array.push_back(7);
+    EXPECT_EQ(to_vector(array), (std::vector<int>{1, 2, 3, 4, 5, 6, 7}));
+}
+
+TEST_F(DynamicArrayTest, SpliceSingleElementAndRange) {
+    DynamicArray<int> array({10, 20}, *alloc);
+    DynamicArray<int> other({1, 2, 3, 4, 5}, *alloc);
+    
+    // Один элемент: тот, что следует за итератором
+    array.splice_after(array.before_begin(), other, other.before_begin());
+    EXPECT_EQ(to_vector(array), (std::vector<int>{1, 10, 20}));
+    EXPECT_EQ(to_vector(other), (std::vector<int>{2, 3, 4, 5}));
+    
+    // Интервал (first, last) с хвостом other
+    array.splice_after(std::next(array.begin(), 2), other, other.begin(), other.end());
+    EXPECT_EQ(to_vector(array), (std::vector<int>{1, 10, 20, 3, 4, 5}));
+    EXPECT_EQ(to_vector(other), (std::vector<int>{2}));
+    EXPECT_EQ(array.back(), 5);
+    EXPECT_EQ(other.back(), 2);
+    EXPECT_EQ(array.size(), 6);
+    EXPECT_EQ(other.size(), 1);
+    
+    // Перестановка внутри одного массива
+    array.splice_after(array.before_begin(), array, std::next(array.begin(), 4));
+    EXPECT_EQ(to_vector(array), (std::vector<int>{5, 1, 10, 20, 3, 4}));
+    EXPECT_EQ(array.back(), 4);
+}
+
+TEST(DynamicArraySpliceTest, DifferentResourcesMoveElements) {
+    DynamicBlockMemoryResource first_resource;
+    DynamicBlockMemoryResource second_resource;
+    first_resource.set_logging(false);
+    second_resource.set_logging(false);
+    std::pmr::polymorphic_allocator<ComplexType> first_alloc(&first_resource);
+    std::pmr::polymorphic_allocator<ComplexType> second_alloc(&second_resource);
+    
+    DynamicArray<ComplexType> array(first_alloc);
+    DynamicArray<ComplexType> other(second_alloc);
+    array.emplace_back(1, "One", 1.0);
+    other.emplace_back(2, "Two", 2.0);
+    other.emplace_back(3, "Three", 3.0);
+    
+    array.splice_after(array.begin(), other);
+    EXPECT_EQ(array.size(), 3);
+    EXPECT_TRUE(other.empty());
+    EXPECT_EQ(std::as_const(array).back().name, "Three");
+    // Элементы и их данные перешли в ресурс принимающего массива
+    EXPECT_EQ(first_resource.allocated_blocks_count(), 6);
+    EXPECT_EQ(second_resource.allocated_blocks_count(), 0);
+    for (const auto& item : std::as_const(array)) {
+        EXPECT_EQ(item.get_allocator().resource(), &first_resource);
+    }
+}
+
+TEST(DynamicArraySpliceTest, SpliceDetachesSharedStorage) {
+    DynamicArray<int> original({1, 2, 3});
+    original.set_copy_on_write(true);
+    DynamicArray<int> copy(original);
+    DynamicArray<int> other({9});
+    
+    copy.splice_after(std::next(copy.cbegin()), other);
+    copy.erase_after(copy.cbegin());
+    EXPECT_EQ(to_vector(copy), (std::vector<int>{1, 9, 3}));
+    EXPECT_EQ(to_vector(original), (std::vector<int>{1, 2, 3}));
+}
+
+TEST(DynamicArraySpliceTest, SelfSpliceOnSharedCopy) {
+    DynamicArray<int> original({1, 2, 3, 4});
+    original.set_copy_on_write(true);
+    DynamicArray<int> copy(original);
+    
+    copy.splice_after(copy.cbefore_begin(), copy, copy.cbegin());
+    EXPECT_EQ(to_vector(copy), (std::vector<int>{2, 1, 3, 4}));
+    EXPECT_EQ(copy.size(), 4u);
+    EXPECT_EQ(to_vector(original), (std::vector<int>{1, 2, 3, 4}));
+    EXPECT_EQ(original.size(), 4u);
+    
+    DynamicArray<int> range_copy(original);
+    EXPECT_THROW(range_copy.splice_after(range_copy.cbefore_begin(), range_copy,
+                                         range_copy.cbegin(), range_copy.cend()),
+                 std::invalid_argument);
+    EXPECT_TRUE(range_copy.is_shared());
+    EXPECT_EQ(to_vector(original), (std::vector<int>{1, 2, 3, 4}));
+}
+
+// ==================== Тесты для compact ====================
+TEST_F(DynamicArrayTest, CompactPacksElementsInOrder) {
+    DynamicArray<int> array(*alloc);
+    DynamicArray<int> interleaved(*alloc);
+    for (int i = 0; i < 50; ++i) {
+        array.push_back(i);
+        interleaved.push_back(-i);
+    }
+    interleaved.clear();
+    EXPECT_EQ(resource->allocated_blocks_count(), 50);
+    
+    CompactionReport report = array.compact();
+    EXPECT_EQ(report.elements, 50u);
+    EXPECT_GT(report.mean_gap_before, 0.0);
+    EXPECT_LT(report.mean_gap_after, report.mean_gap_before);
+    EXPECT_GT(report.locality_gain(), 1.0);
+    // Все элементы теперь в одном блоке ресурса с постоянным шагом
+    EXPECT_EQ(resource->allocated_blocks_count(), 1);
+    
+    std::vector<int> values;
+    const int* previous = nullptr;
+    std::ptrdiff_t stride = 0;
+    for (auto it = array.cbegin(); it != array.cend(); ++it) {
+        values.push_back(*it);
+        if (previous != nullptr) {
+            std::ptrdiff_t gap = reinterpret_cast<const char*>(&*it) - reinterpret_cast<const char*>(previous);
+            if (stride == 0) {
+                stride = gap;
+            }
+            EXPECT_EQ(gap, stride);
+        }
+        previous = &*it;
+    }
+    EXPECT_GT(stride, 0);
+    EXPECT_EQ(values.size(), 50u);
+    for (int i = 0; i < 50; ++i) {
+        EXPECT_EQ(values[i], i);
+    }
+}
+
+TEST_F(DynamicArrayTest, CompactedArrayStaysMutable) {
+    DynamicArray<int> array({1, 2, 3, 4}, *alloc);
+    array.shrink_to_fit();
+    
+    array.pop_back();
+    array.pop_front();
+    array.push_back(5);
+    EXPECT_EQ(to_vector(array), (std::vector<int>{2, 3, 5}));
+    // Блок жив, пока в нём есть элементы, плюс отдельный элемент 5
+    EXPECT_EQ(resource->allocated_blocks_count(), 2);
+    
+    array.compact();
+    EXPECT_EQ(resource->allocated_blocks_count(), 1);
+    
+    DynamicArray<int> other(*alloc);
+    other.push_back(0);
+    other.splice_after(other.begin(), array, array.begin());
+    array.clear();
+    EXPECT_EQ(resource->allocated_blocks_count(), 2);
+    other.clear();
+    EXPECT_EQ(resource->allocated_blocks_count(), 0);
+}
+
+TEST(DynamicArrayCompactTest, ComplexTypeMovedWithoutReallocatingBuffers) {
+    DynamicBlockMemoryResource resource;
+    resource.set_logging(false);
+    DynamicArray<ComplexType> array{std::pmr::polymorphic_allocator<ComplexType>(&resource)};
+    array.emplace_back(1, "A name long enough to live on the heap", 1.0);
+    array.emplace_back(2, "Another name long enough for the heap", 2.0);
+    const char* name_buffer = std::as_const(array).front().name.data();
+    
+    array.compact();
+    // Элементы перемещены: строки и векторы сохранили свои буферы
+    EXPECT_EQ(std::as_const(array).front().name.data(), name_buffer);
+    EXPECT_EQ(std::as_const(array).back().id, 2);
+    // Один плотный блок + имя и data каждого элемента
+    EXPECT_EQ(resource.allocated_blocks_count(), 5);
+    
+    array.clear();
+    EXPECT_EQ(resource.allocated_blocks_count(), 0);
+}
+
+TEST(DynamicArrayCompactTest, CompactDetachesSharedStorage) {
+    DynamicArray<int> original({1, 2, 3});
+    original.set_copy_on_write(true);
+    DynamicArray<int> copy(original);
+    
+    copy.compact();
+    EXPECT_FALSE(original.is_shared());
+    EXPECT_EQ(to_vector(copy), (std::vector<int>{1, 2, 3}));
+    EXPECT_EQ(to_vector(original), (std::vector<int>{1, 2, 3}));
+}
+
+// ==================== Тесты для copy-on-write ====================
+TEST(CopyOnWriteTest, CopiesShareStorageUntilMutation) {
+    DynamicBlockMemoryResource resource;
+    resource.set_logging(false);
+    std::pmr::polymorphic_allocator<int> alloc(&resource);
+    
+    DynamicArray<int> original({1, 2, 3}, alloc);
+    original.set_copy_on_write(true);
+    
+    DynamicArray<int> copy(original);
+    EXPECT_TRUE(copy.copy_on_write());
+    EXPECT_TRUE(original.is_shared());
+    EXPECT_TRUE(copy.is_shared());
+    EXPECT_EQ(&*copy.cbegin(), &*original.cbegin());
+    EXPECT_EQ(resource.allocated_blocks_count(), 3);
+    
+    // Первое изменение копирует элементы только в изменяемый массив
+    copy.push_back(4);
+    EXPECT_FALSE(copy.is_shared());
+    EXPECT_FALSE(original.is_shared());
+    EXPECT_EQ(copy.size(), 4);
+    EXPECT_EQ(original.size(), 3);
+    EXPECT_EQ(original.back(), 3);
+    EXPECT_EQ(resource.allocated_blocks_count(), 7);
+}
+
+TEST(CopyOnWriteTest, NonConstAccessDetaches) {
+    DynamicArray<int> original({1, 2, 3});
+    original.set_copy_on_write(true);
+    DynamicArray<int> copy = original;
+    
+    *copy.begin() = 100;
+    EXPECT_EQ(copy.front(), 100);
+    EXPECT_EQ(std::as_const(original).front(), 1);
+    
+    DynamicArray<int> second = original;
+    second.back() = 300;
+    second.pop_back();
+    EXPECT_EQ(second.size(), 2);
+    EXPECT_EQ(original.size(), 3);
+    EXPECT_EQ(std::as_const(original).back(), 3);
+}
+
+TEST(CopyOnWriteTest, LastOwnerFreesStorage) {
+    DynamicBlockMemoryResource resource;
+    resource.set_logging(false);
+    std::pmr::polymorphic_allocator<ComplexType> alloc(&resource);
+    
+    {
+        DynamicArray<ComplexType> copy(alloc);
+        {
+            DynamicArray<ComplexType> original(alloc);
+            original.set_copy_on_write(true);
+            original.emplace_back(1, "One", 1.0);
+            original.emplace_back(2, "Two", 2.0);
+            
+            DynamicArray<ComplexType> second(original);
+            copy = second;
+            EXPECT_EQ(resource.allocated_blocks_count(), 4);
+        }
+        // Исходный массив уничтожен, копия остаётся единственным владельцем
+        EXPECT_EQ(resource.allocated_blocks_count(), 4);
+        EXPECT_FALSE(copy.is_shared());
+        EXPECT_EQ(std::as_const(copy).front().name, "One");
+        
+        copy.push_back(ComplexType(3, "Three", 3.0));
+        EXPECT_EQ(resource.allocated_blocks_count(), 6);
+    }
+    EXPECT_EQ(resource.allocated_blocks_count(), 0);
+}
+
+TEST(CopyOnWriteTest, ConcurrentCopiesOfConstArray) {
+    for (int round = 0; round < 50; ++round) {
+        DynamicArray<int> source({1, 2, 3});
+        source.set_copy_on_write(true);
+        const DynamicArray<int>& shared = source;
+        
+        std::vector<std::thread> threads;
+        std::atomic<int> mismatches{0};
+        for (int t = 0; t < 4; ++t) {
+            threads.emplace_back([&] {
+                for (int i = 0; i < 100; ++i) {
+                    DynamicArray<int> copy(shared);
+                    if (copy.size() != 3 || copy.front() != 1) {
+                        mismatches++;
+                    }
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        EXPECT_EQ(mismatches.load(), 0);
+        EXPECT_FALSE(source.is_shared());
+    }
+}
+
+TEST(CopyOnWriteTest, DisabledByDefault) {
+    DynamicArray<int> original({1, 2, 3});
+    DynamicArray<int> copy(original);
+    EXPECT_FALSE(copy.is_shared());
+    EXPECT_NE(&*copy.cbegin(), &*original.cbegin());
+}
+
+// ==================== Тесты для views ====================
+TEST(DynamicArrayViewsTest, FilterTransformTakeDrop) {
+    DynamicArray<int> array({1, 2, 3, 4, 5, 6, 7, 8, 9, 10});
+    
+    auto odd_squares = array 
+        | views::filter([](int x) { return x % 2 == 1; })
+        | views::transform([](int x) { return x * x; });
+    std::vector<int> result(odd_squares.begin(), odd_squares.end());
+    EXPECT_EQ(result, (std::vector<int>{1, 9, 25, 49, 81}));
+    
+    auto middle = array | views::drop(3) | views::take(4);
+    result.assign(middle.begin(), middle.end());
+    EXPECT_EQ(result, (std::vector<int>{4, 5, 6, 7}));
+    
+    auto beyond = array | views::drop(20);
+    EXPECT_EQ(beyond.begin(), beyond.end());
+    auto everything = array | views::take(100);
+    EXPECT_EQ(std::distance(everything.begin(), everything.end()), 10);
+}
+
+TEST(DynamicArrayViewsTest, Chunk) {
+    DynamicArray<int> array({1, 2, 3, 4, 5, 6, 7});
+    
+    std::vector<int> sums;
+    for (auto chunk : array | views::chunk(3)) {
+        int sum = 0;
+        for (int x : chunk) {
+            sum += x;
+        }
+        sums.push_back(sum);
+    }
+    EXPECT_EQ(sums, (std::vector<int>{6, 15, 7}));
+}
+
+TEST(DynamicArrayViewsTest, ViewsAreLazyAndDoNotAllocate) {
+    DynamicBlockMemoryResource resource;
+    resource.set_logging(false);
+    std::pmr::polymorphic_allocator<ComplexType> alloc(&resource);
+    
+    DynamicArray<ComplexType> array(alloc);
+    for (int i = 0; i < 20; ++i) {
+        array.emplace_back(i, "Item", i * 1.5);
+    }
+    std::size_t blocks = resource.allocated_blocks_count();
+    
+    int predicate_calls = 0;
+    auto values = array 
+        | views::filter([&predicate_calls](const ComplexType& item) {
+              ++predicate_calls;
+              return item.id > 15;
+          })
+        | views::transform([](const ComplexType& item) { return item.value; });
+    // До обхода ничего не вычисляется
+    EXPECT_EQ(predicate_calls, 0);
+    
+    double sum = 0;
+    for (double value : values) {
+        sum += value;
+    }
+    EXPECT_DOUBLE_EQ(sum, (16 + 17 + 18 + 19) * 1.5);
+    EXPECT_EQ(resource.allocated_blocks_count(), blocks);
+    
+    // Материализация выделяет память только под результат
+    DynamicArray<double> collected = views::to_dynamic_array(
+        values, std::pmr::polymorphic_allocator<double>(&resource));
+    EXPECT_EQ(collected.size(), 4);
+    EXPECT_EQ(resource.allocated_blocks_count(), blocks + 4);
+}
+
+TEST(DynamicArrayViewsTest, ViewsOverConstArrayAreReadOnly) {
+    const DynamicArray<int> array({1, 2, 3});
+    auto view = array | views::take(2);
+    static_assert(std::is_same_v<decltype(*view.begin()), const int&>);
+    EXPECT_EQ(*view.begin(), 1);
+}
+
+TEST(DynamicArrayViewsTest, ViewsKeepCopyOnWriteStorageShared) {
+    DynamicBlockMemoryResource resource;
+    resource.set_logging(false);
+    DynamicArray<int> original({1, 2, 3, 4}, &resource);
+    original.set_copy_on_write(true);
+    DynamicArray<int> copy(original);
+    ASSERT_TRUE(copy.is_shared());
+    
+    int sum = 0;
+    for (int value : copy | views::filter([](int x) { return x % 2 == 0; })
+                          | views::transform([](int x) { return x * 10; })) {
+        sum += value;
+    }
+    EXPECT_EQ(sum, 60);
+    EXPECT_TRUE(copy.is_shared());
+    EXPECT_EQ(resource.allocated_blocks_count(), 4);
+}
+
+// ==================== Тесты для ComplexTypeLoader ====================
+TEST(ComplexTypeLoaderTest, LoadCsv) {
+    std::istringstream in("1,First,1.5,10,20\r\n\n2,Second,2.25\n3,Third,-3e2,7");
+    DynamicBlockMemoryResource resource;
+    DynamicArray<ComplexType> array{std::pmr::polymorphic_allocator<ComplexType>(&resource)};
+    
+    LoadStats stats = ComplexTypeLoader().load(in, array);
+    EXPECT_EQ(stats.records, 3);
+    EXPECT_EQ(stats.bytes, in.str().size());
+    ASSERT_EQ(array.size(), 3);
+    
+    auto it = array.begin();
+    EXPECT_EQ(it->id, 1);
+    EXPECT_EQ(it->name, "First");
+    EXPECT_DOUBLE_EQ(it->value, 1.5);
+    EXPECT_EQ(it->data, (std::pmr::vector<int>{10, 20}));
+    ++it;
+    // Без данных остаётся значение по умолчанию из конструктора
+    EXPECT_EQ(it->name, "Second");
+    EXPECT_EQ(it->data, (std::pmr::vector<int>{2, 4, 6}));
+    ++it;
+    EXPECT_DOUBLE_EQ(it->value, -300.0);
+    EXPECT_EQ(it->data, (std::pmr::vector<int>{7}));
+}
+
+TEST(ComplexTypeLoaderTest, MalformedCsvThrows) {
+    std::istringstream in("1,Ok,1.0\n2,Broken,not_a_number\n");
+    DynamicArray<ComplexType> array;
+    EXPECT_THROW(ComplexTypeLoader().load(in, array), std::runtime_error);
+    EXPECT_EQ(array.size(), 1);
+}
+
+TEST(ComplexTypeLoaderTest, BinaryRoundTripWithSmallBlocks) {
+    std::ostringstream out;
+    for (int i = 0; i < 20; ++i) {
+        ComplexType item(i, "Record number " + std::to_string(i), i * 0.5);
+        write_binary_record(out, item);
+    }
+    
+    std::istringstream in(out.str());
+    // Блок меньше одной записи: хвосты переносятся, буфер растёт
+    ComplexTypeLoader loader(ComplexTypeLoader::Format::Binary, 8, 4);
+    DynamicArray<ComplexType> array;
+    LoadStats stats = loader.load(in, array);
+    
+    EXPECT_EQ(stats.records, 20);
+    ASSERT_EQ(array.size(), 20);
+    int expected = 0;
+    for (const auto& item : array) {
+        EXPECT_EQ(item.id, expected);
+        EXPECT_EQ(std::string_view(item.name), "Record number " + std::to_string(expected));
+        EXPECT_DOUBLE_EQ(item.value, expected * 0.5);
+        EXPECT_EQ(item.data, (std::pmr::vector<int>{expected, expected * 2, expected * 3}));
+        ++expected;
+    }
+}
+
+TEST(ComplexTypeLoaderTest, TruncatedBinaryThrows) {
+    std::ostringstream out;
+    write_binary_record(out, ComplexType(1, "One", 1.0));
+    std::string bytes = out.str();
+    bytes.pop_back();
+    
+    std::istringstream in(bytes);
+    DynamicArray<ComplexType> array;
+    EXPECT_THROW(ComplexTypeLoader(ComplexTypeLoader::Format::Binary).load(in, array),
+                 std::runtime_error);
+}
+
+TEST(ComplexTypeLoaderTest, LoadBatchesKeepsMemoryBounded) {
+    std::string csv;
+    for (int i = 0; i < 10; ++i) {
+        csv += std::to_string(i) + ",Item,1.0\n";
+    }
+    std::istringstream in(csv);
+    
+    DynamicBlockMemoryResource resource;
+    std::vector<std::size_t> batch_sizes;
+    std::size_t max_live_blocks = 0;
+    int next_id = 0;
+    
+    ComplexTypeLoader loader(ComplexTypeLoader::Format::Csv, 16, 4);
+    LoadStats stats = loader.load_batches(in, [&](DynamicArray<ComplexType>& batch) {
+        batch_sizes.push_back(batch.size());
+        max_live_blocks = std::max(max_live_blocks, resource.allocated_blocks_count());
+        for (const auto& item : batch) {
+            EXPECT_EQ(item.id, next_id++);
+        }
+    }, std::pmr::polymorphic_allocator<ComplexType>(&resource));
+    
+    EXPECT_EQ(stats.records, 10);
+    EXPECT_EQ(batch_sizes, (std::vector<std::size_t>{4, 4, 2}));
+    // Не больше одной пачки: элемент и его вектор data на запись
+    EXPECT_LE(max_live_blocks, 8u);
+    EXPECT_EQ(resource.allocated_blocks_count(), 0);
+}
+
+// ==================== Тесты для LatencyHistogram ====================
+TEST(LatencyHistogramTest, EmptyHistogram) {
+    LatencyHistogram histogram;
+    EXPECT_EQ(histogram.count(), 0u);
+    EXPECT_EQ(histogram.percentile(50.0), 0u);
+    EXPECT_EQ(histogram.max(), 0u);
+}
+
+TEST(LatencyHistogramTest, ExactSmallValues) {
+    LatencyHistogram histogram;
+    for (std::uint64_t i = 1; i <= 100; ++i) {
+        histogram.record(i);
+    }
+    EXPECT_EQ(histogram.count(), 100u);
+    EXPECT_EQ(histogram.min(), 1u);
+    EXPECT_EQ(histogram.max(), 100u);
+    EXPECT_EQ(histogram.percentile(50.0), 50u);
+    EXPECT_EQ(histogram.percentile(99.0), 99u);
+    EXPECT_EQ(histogram.percentile(100.0), 100u);
+    EXPECT_DOUBLE_EQ(histogram.mean(), 50.5);
+}
+
+TEST(LatencyHistogramTest, RelativePrecisionForLargeValues) {
+    LatencyHistogram histogram;
+    for (std::uint64_t i = 1; i <= 100000; ++i) {
+        histogram.record(i * 1000);
+    }
+    auto p50 = static_cast<double>(histogram.percentile(50.0));
+    auto p999 = static_cast<double>(histogram.percentile(99.9));
+    EXPECT_NEAR(p50, 50'000'000.0, 50'000'000.0 / 64);
+    EXPECT_NEAR(p999, 99'900'000.0, 99'900'000.0 / 64);
+    EXPECT_EQ(histogram.percentile(100.0), 100'000'000u);
+}
+
+TEST(LatencyHistogramTest, TailSpikeAndMerge) {
+    LatencyHistogram fast;
+    LatencyHistogram slow;
+    for (int i = 0; i < 999; ++i) {
+        fast.record(100);
+    }
+    slow.record(5'000'000);
+    
+    fast.merge(slow);
+    EXPECT_EQ(fast.count(), 1000u);
+    EXPECT_LE(fast.percentile(99.0), 101u);
+    EXPECT_GE(fast.percentile(100.0), 5'000'000u - 5'000'000u / 64);
+    EXPECT_EQ(fast.max(), 5'000'000u);
+    
+    std::ostringstream out;
+    fast.report(out, "op");
+    EXPECT_NE(out.str().find("p999="), std::string::npos);
+    
+    fast.reset();
+    EXPECT_EQ(fast.count(), 0u);
+}
+
+#ifdef LAB5_LATENCY_HISTOGRAMS
+TEST(LatencyHistogramTest, DynamicArrayOperationsAreRecorded) {
+    DynamicBlockMemoryResource resource;
+    resource.set_logging(false);
+    DynamicArray<int> array{std::pmr::polymorphic_allocator<int>(&resource)};
+    
+    for (int i = 0; i < 10; ++i) {
+        array.push_back(i);
+    }
+    array.pop_back();
+    DynamicArray<int> copy(array);
+    DynamicArray<int> moved(std::move(copy));
+    array.clear();
+    
+    const DynamicArrayLatency& stats = array.latency_stats();
+    EXPECT_EQ(stats.push_back.count(), 10u);
+    EXPECT_EQ(stats.pop_back.count(), 1u);
+    EXPECT_EQ(stats.clear.count(), 1u);
+    EXPECT_EQ(moved.latency_stats().move.count(), 1u);
+    // Копия выделяет элементы одним вызовом allocate_bulk, clear
+    // освобождает их одним deallocate_bulk
+    EXPECT_EQ(resource.latency_stats().allocate.count(), 10u);
+    EXPECT_EQ(resource.latency_stats().allocate_bulk.count(), 1u);
+    EXPECT_EQ(resource.latency_stats().deallocate.count(), 1u);
+    EXPECT_EQ(resource.latency_stats().deallocate_bulk.count(), 1u);
+}
+
+TEST(LatencyHistogramTest, ArrayHistogramsAreAllocatedOnFirstUse) {
+    // Гистограммы не входят в сам объект массива
+    static_assert(sizeof(DynamicArray<int>) < sizeof(LatencyHistogram));
+    std::vector<DynamicArray<int>> nested(1000);
+    EXPECT_EQ(nested.front().latency_stats().push_back.count(), 0u);
+    
+    nested.front().push_back(1);
+    EXPECT_EQ(nested.front().latency_stats().push_back.count(), 1u);
+    
+    // Перемещённый массив забирает гистограммы вместе с содержимым
+    DynamicArray<int> moved(std::move(nested.front()));
+    EXPECT_EQ(moved.latency_stats().push_back.count(), 1u);
+    EXPECT_EQ(moved.latency_stats().move.count(), 1u);
+    EXPECT_EQ(nested.front().latency_stats().push_back.count(), 0u);
+    moved.reset_latency_stats();
+    EXPECT_EQ(moved.latency_stats().push_back.count(), 0u);
+    
+    // Перемещение и уничтожение не создают набор у массива без замеров:
+    // оба массива отдают общий пустой набор
+    DynamicArray<int> target;
+    target = std::move(nested.back());
+    nested.clear();
+    EXPECT_EQ(target.latency_stats().move.count(), 0u);
+    EXPECT_EQ(&target.latency_stats(), &moved.latency_stats());
+}
+
+#endif
+
+// ==================== Тесты для BackgroundReclaimer ====================
+
+// Запоминает поток, в котором был уничтожен объект
+struct ThreadTrackingItem {
+    static std::atomic<int> destroyed;
+    static std::thread::id destroyer;
+    int value;
+    
+    ThreadTrackingItem(int v = 0) : value(v) {}
+    ThreadTrackingItem(const ThreadTrackingItem&) = default;
+    ~ThreadTrackingItem() {
+        destroyer = std::this_thread::get_id();
+        destroyed++;
+    }
+};
+
+std::atomic<int> ThreadTrackingItem::destroyed{0};
+std::thread::id ThreadTrackingItem::destroyer;
+
+TEST(BackgroundReclaimerTest, ClearDefersDestructionToWorker) {
+    DynamicBlockMemoryResource resource;
+    resource.set_logging(false);
+    BackgroundReclaimer reclaimer(16);
+    ThreadTrackingItem::destroyed = 0;
+    
+    DynamicArray<ThreadTrackingItem> array{std::pmr::polymorphic_allocator<ThreadTrackingItem>(&resource)};
+    array.set_reclaimer(&reclaimer);
+    for (int i = 0; i < 100; ++i) {
+        array.emplace_back(i);
+    }
+    int destroyed_before = ThreadTrackingItem::destroyed;
+    
+    array.clear();
+    EXPECT_TRUE(array.empty());
+    
+    reclaimer.drain();
+    EXPECT_EQ(reclaimer.pending(), 0u);
+    EXPECT_EQ(ThreadTrackingItem::destroyed - destroyed_before, 100);
+    EXPECT_NE(ThreadTrackingItem::destroyer, std::this_thread::get_id());
+    // Память вернулась в исходный ресурс
+    EXPECT_EQ(resource.allocated_blocks_count(), 0);
+}
+
+TEST(BackgroundReclaimerTest, DestructorAndMoveAssignmentAreDeferred) {
+    DynamicBlockMemoryResource resource;
+    resource.set_logging(false);
+    BackgroundReclaimer reclaimer(8);
+    std::pmr::polymorphic_allocator<int> alloc(&resource);
+    
+    {
+        DynamicArray<int> array({1, 2, 3, 4, 5}, alloc);
+        array.set_reclaimer(&reclaimer);
+        
+        DynamicArray<int> other({6, 7}, alloc);
+        array = std::move(other);
+        EXPECT_EQ(array.size(), 2);
+        EXPECT_EQ(array.front(), 6);
+    }
+    
+    reclaimer.drain();
+    EXPECT_EQ(resource.allocated_blocks_count(), 0);
+}
+
+TEST(BackgroundReclaimerTest, ArraysStayUsableWhileReclaiming) {
+    DynamicBlockMemoryResource resource;
+    resource.set_logging(false);
+    BackgroundReclaimer reclaimer(4);
+    std::pmr::polymorphic_allocator<int> alloc(&resource);
+    
+    DynamicArray<int> array(alloc);
+    array.set_reclaimer(&reclaimer);
+    for (int round = 0; round < 50; ++round) {
+        for (int i = 0; i < 200; ++i) {
+            array.push_back(i);
+        }
+        array.clear();
+    }
+    
+    reclaimer.drain();
+    EXPECT_EQ(resource.allocated_blocks_count(), 0);
+}
+
+// ==================== Тесты для MappedFileMemoryResource ====================
+class MappedFileMemoryResourceTest : public ::testing::Test {
+protected:
+    std::string path;
+    
+    void SetUp() override {
+        path = ::testing::TempDir() + "lab5_mapped_" +
+               ::testing::UnitTest::GetInstance()->current_test_info()->name() + ".bin";
+        std::remove(path.c_str());
+    }
+    
+    void TearDown() override {
+        std::remove(path.c_str());
+    }
+};
+
+TEST_F(MappedFileMemoryResourceTest, AllocatesAlignedBlocksAndReusesFreedOnes) {
+    MappedFileMemoryResource file(path);
+    
+    void* small = file.allocate(24, 8);
+    void* aligned = file.allocate(100, 64);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(aligned) % 64, 0u);
+    EXPECT_EQ(file.allocated_blocks_count(), 2u);
+    EXPECT_EQ(file.allocated_bytes(), 32u + 128u);
+    
+    file.deallocate(small, 24, 8);
+    EXPECT_EQ(file.allocated_blocks_count(), 1u);
+    // Освобождённый блок того же класса используется повторно
+    EXPECT_EQ(file.allocate(20, 4), small);
+    
+    file.deallocate(small, 20, 4);
+    EXPECT_THROW(file.deallocate(small, 20, 4), std::runtime_error);
+    file.deallocate(aligned, 100, 64);
+    EXPECT_EQ(file.allocated_blocks_count(), 0u);
+}
+
+TEST_F(MappedFileMemoryResourceTest, GrowsFileWithoutMovingBlocks) {
+    MappedFileMemoryResource file(path, 4096);
+    std::size_t initial = file.file_size();
+    
+    auto* first = static_cast<int*>(file.allocate(sizeof(int) * 256, alignof(int)));
+    for (int i = 0; i < 256; ++i) {
+        first[i] = i;
+    }
+    std::vector<void*> blocks;
+    for (int i = 0; i < 100; ++i) {
+        blocks.push_back(file.allocate(4096, 16));
+    }
+    EXPECT_GT(file.file_size(), initial);
+    // Адрес прежнего блока и его содержимое не изменились
+    EXPECT_EQ(first[255], 255);
+    EXPECT_EQ(file.pointer_at(file.offset_of(first)), first);
+    
+    for (void* block : blocks) {
+        file.deallocate(block, 4096, 16);
+    }
+    file.deallocate(first, sizeof(int) * 256, alignof(int));
+}
+
+TEST_F(MappedFileMemoryResourceTest, PersistedArrayReopensWithoutRebuilding) {
+    void* saved = nullptr;
+    {
+        MappedFileMemoryResource file(path, 4096);
+        PersistentArray<int> array{ResourceAllocator<int, MappedFileMemoryResource>(&file)};
+        for (int i = 0; i < 1000; ++i) {
+            array.push_back(i);
+        }
+        array.pop_front();
+        array.push_back(1000);
+        // Элемент и узел - отдельные блоки файла
+        EXPECT_EQ(file.allocated_blocks_count(), 2000u);
+        
+        persist_array(file, 3, std::move(array));
+        EXPECT_TRUE(array.empty());
+        EXPECT_NE(file.root(3), nullptr);
+        // В файле остаются один плотный блок узлов с элементами и запись о цепочке
+        EXPECT_EQ(file.allocated_blocks_count(), 2u);
+        PersistentArray<int> empty{ResourceAllocator<int, MappedFileMemoryResource>(&file)};
+        EXPECT_THROW(persist_array(file, 3, std::move(empty)), std::runtime_error);
+        saved = file.root(3);
+        file.flush();
+    }
+    
+    // Прежний адрес свободен: файл отображается туда же, указатели в узлах действительны
+    MappedFileMemoryResource file(path);
+    EXPECT_EQ(file.root(3), saved);
+    {
+
+        HeapAllocationCounter heap;
+        PersistentArray<int> array = restore_array<int>(file, 3);
+        EXPECT_EQ(heap.allocations, 0u);
+        EXPECT_EQ(file.root(3), nullptr);
+        EXPECT_EQ(file.allocated_blocks_count(), 1u);
+        ASSERT_EQ(array.size(), 1000);
+        int expected = 1;
+        for (int value : std::as_const(array)) {
+            EXPECT_EQ(value, expected++);
+        }
+        
+        // Восстановленный массив остаётся обычным массивом
+        array.push_back(1001);
+        array.pop_front();
+        EXPECT_EQ(array.front(), 2);
+        EXPECT_EQ(array.back(), 1001);
+        persist_array(file, 4, std::move(array));
+        EXPECT_THROW(restore_array<double>(file, 4), std::runtime_error);
+        array = restore_array<int>(file, 4);
+        EXPECT_EQ(array.size(), 1000);
+    }
+    EXPECT_EQ(file.allocated_blocks_count(), 0u);
+}
+
+TEST_F(MappedFileMemoryResourceTest, PersistedArrayIsRelocatedWhenMappedElsewhere) {
+    {
+        MappedFileMemoryResource file(path);
+        PersistentArray<int> array{ResourceAllocator<int, MappedFileMemoryResource>(&file)};
+        for (int i = 0; i < 100; ++i) {
+            array.push_back(i);
+        }
+        persist_array(file, 0, std::move(array));
+    }
+    
+    // Прежний адрес занят первым отображением, второе получает другой
+    MappedFileMemoryResource first(path);
+    MappedFileMemoryResource second(path);
+    ASSERT_NE(first.root(0), second.root(0));
+    {
+        PersistentArray<int> array = restore_array<int>(second, 0);
+        ASSERT_EQ(array.size(), 100);
+        int expected = 0;
+        for (int value : std::as_const(array)) {
+            EXPECT_EQ(value, expected++);
+        }
+        array.pop_back();
+        array.push_back(-1);
+        EXPECT_EQ(array.back(), -1);
+    }
+    EXPECT_EQ(second.allocated_blocks_count(), 0u);
+}
+
+
+TEST_F(MappedFileMemoryResourceTest, ServesAsUpstreamForDynamicBlockResource) {
+    MappedFileMemoryResource file(path);
+    {
+        DynamicBlockMemoryResource resource(&file);
+        resource.set_logging(false);
+        ComplexType::set_logging(false);
+        DynamicArray<ComplexType> array{std::pmr::polymorphic_allocator<ComplexType>(&resource)};
+        for (int i = 0; i < 50; ++i) {
+            array.emplace_back(i, "A name long enough to need the heap", i * 1.0);
+        }
+        EXPECT_EQ(file.allocated_blocks_count(), resource.allocated_blocks_count());
+        EXPECT_EQ(std::as_const(array).back().name, "A name long enough to need the heap");
+        array.clear();
+        ComplexType::set_logging(true);
+    }
+    EXPECT_EQ(file.allocated_blocks_count(), 0u);
+}
+
+TEST_F(MappedFileMemoryResourceTest, RejectsForeignFiles) {
+    {
+        std::ofstream out(path, std::ios::binary);
+        out << std::string(8192, 'x');
+    }
+    EXPECT_THROW(MappedFileMemoryResource file(path), std::runtime_error);
+}
+
+// ==================== Тесты для SnapshotArray ====================
+TEST(SnapshotArrayTest, SnapshotIsStableWhileWriterAppends) {
+    SnapshotArray<int> array;
+    for (int i = 0; i < 5; ++i) {
+        array.push_back(i);
+    }
+    
+    auto snapshot = array.snapshot();
+    for (int i = 5; i < 10; ++i) {
+        array.push_back(i);
+    }
+    array.pop_front();
+    
+    EXPECT_EQ(snapshot.size(), 5u);
+    EXPECT_EQ(std::vector<int>(snapshot.begin(), snapshot.end()), (std::vector<int>{0, 1, 2, 3, 4}));
+    
+    auto later = array.snapshot();
+    EXPECT_EQ(later.size(), 9u);
+    EXPECT_EQ(*later.begin(), 1);
+    EXPECT_EQ(array.front(), 1);
+    EXPECT_EQ(array.back(), 9);
+}
+
+TEST(SnapshotArrayTest, RemovedElementsLiveUntilNoSnapshotSeesThem) {
+    DynamicBlockMemoryResource resource;
+    resource.set_logging(false);
+    EpochDomain domain;
+    SnapshotArray<int> array(domain, std::pmr::polymorphic_allocator<int>(&resource));
+    array.set_retire_batch(1);
+    for (int i = 0; i < 10; ++i) {
+        array.push_back(i);
+    }
+    
+    auto snapshot = array.snapshot();
+    array.pop_front();
+    array.pop_front();
+    array.collect();
+    // Снимок ещё видит снятые элементы: память не освобождена
+    EXPECT_EQ(resource.allocated_blocks_count(), 10);
+    EXPECT_EQ(domain.retired_count(), 2u);
+    EXPECT_EQ(*snapshot.begin(), 0);
+    
+    snapshot.release();
+    EXPECT_EQ(array.collect(), 2u);
+    EXPECT_EQ(resource.allocated_blocks_count(), 8);
+    
+    array.clear();
+    EXPECT_TRUE(array.empty());
+    EXPECT_TRUE(array.snapshot().empty());
+    array.collect();
+    EXPECT_EQ(resource.allocated_blocks_count(), 0);
+    
+    array.push_back(42);
+    EXPECT_EQ(array.snapshot().size(), 1u);
+    EXPECT_THROW({ array.pop_front(); array.pop_front(); }, std::out_of_range);
+}
+
+TEST(SnapshotArrayTest, ReclamationCanRunInBackground) {
+    DynamicBlockMemoryResource resource;
+    resource.set_logging(false);
+    BackgroundReclaimer reclaimer;
+    EpochDomain domain;
+    domain.set_reclaimer(&reclaimer);
+    {
+        SnapshotArray<ComplexType> array(domain, std::pmr::polymorphic_allocator<ComplexType>(&resource));
+        ComplexType::set_logging(false);
+        for (int i = 0; i < 100; ++i) {
+            array.emplace_back(i, "item", i * 1.0);
+        }
+        array.clear();
+        array.collect();
+        reclaimer.drain();
+        EXPECT_EQ(resource.allocated_blocks_count(), 0);
+        ComplexType::set_logging(true);
+    }
+}
+
+// Один писатель дописывает в конец и держит окно фиксированного размера,
+// читатели непрерывно берут снимки и проверяют, что каждый из них - непрерывный
+// отрезок последовательности нужной длины
+TEST(SnapshotArrayTest, StressSingleWriterManyReaders) {
+    DynamicBlockMemoryResource resource;
+    resource.set_logging(false);
+    const int total = 20000;
+    const size_t window = 256;
+    std::atomic<bool> done{false};
+    std::atomic<int> failures{0};
+    std::atomic<long> snapshots{0};
+    
+    {
+        SnapshotArray<int> array{std::pmr::polymorphic_allocator<int>(&resource)};
+        array.set_retire_batch(16);
+        
+        std::vector<std::thread> readers;
+        for (int r = 0; r < 3; ++r) {
+            readers.emplace_back([&] {
+                while (!done.load(std::memory_order_acquire)) {
+                    auto snapshot = array.snapshot();
+                    size_t count = 0;
+                    int previous = -1;
+                    for (int value : snapshot) {
+                        if (previous >= 0 && value != previous + 1) {
+                            failures++;
+                        }
+                        previous = value;
+                        count++;
+                    }
+                    if (count != snapshot.size() || count > window + 1) {
+                        failures++;
+                    }
+                    snapshots++;
+                    std::this_thread::yield();
+                }
+            });
+        }
+        
+        for (int i = 0; i < total; ++i) {
+            array.push_back(i);
+            if (array.size() > window) {
+                array.pop_front();
+            }
+            if (i % 1000 == 0) {
+                std::this_thread::yield();
+            }
+        }
+        done.store(true, std::memory_order_release);
+        for (auto& reader : readers) {
+            reader.join();
+        }
+        
+        EXPECT_EQ(failures.load(), 0);
+        EXPECT_GT(snapshots.load(), 0);
+        array.collect();
+        EXPECT_EQ(array.domain().retired_count(), 0u);
+        EXPECT_EQ(resource.allocated_blocks_count(), static_cast<int>(window));
+    }
+    EXPECT_EQ(resource.allocated_blocks_count(), 0);
+}
+
+// ==================== Тесты для пула повторного использования ====================
+TEST(RecyclingPoolTest, RemovedElementsAreReusedInPlace) {
+    DynamicBlockMemoryResource resource;
+    resource.set_logging(false);
+    {
+        DynamicArray<ComplexType> array{std::pmr::polymorphic_allocator<ComplexType>(&resource)};
+        array.set_recycling(8);
+        EXPECT_EQ(array.recycling_limit(), 8u);
+        
+        const std::string long_name(100, 'x');
+        array.emplace_back(1, long_name, 1.5);
+        ComplexType* element = &array.back();
+        size_t name_capacity = element->name.capacity();
+        size_t blocks = resource.allocated_blocks_count();
+        
+        array.pop_back();
+        EXPECT_TRUE(array.empty());
+        EXPECT_EQ(array.pooled(), 1u);
+        EXPECT_EQ(resource.allocated_blocks_count(), blocks);
+        
+        ComplexType& reused = array.emplace_back(2, "short", 2.5);
+        EXPECT_EQ(&reused, element);
+        EXPECT_EQ(reused.name.capacity(), name_capacity);
+        EXPECT_EQ(reused.id, 2);
+        EXPECT_EQ(reused.name, "short");
+        EXPECT_DOUBLE_EQ(reused.value, 2.5);
+        EXPECT_EQ(reused.data, (std::pmr::vector<int>{2, 4, 6}));
+        EXPECT_EQ(array.pooled(), 0u);
+        EXPECT_EQ(resource.allocated_blocks_count(), blocks);
+    }
+    EXPECT_EQ(resource.allocated_blocks_count(), 0);
+}
+
+TEST(RecyclingPoolTest, ChurnDoesNotAllocate) {
+    DynamicBlockMemoryResource resource;
+    resource.set_logging(false);
+    {
+        DynamicArray<ComplexType> array{std::pmr::polymorphic_allocator<ComplexType>(&resource)};
+        array.set_recycling(16);
+        for (int i = 0; i < 16; ++i) {
+            array.emplace_back(i, "element with a long enough name", 0.0);
+        }
+        size_t blocks = resource.allocated_blocks_count();
+        
+        for (int i = 16; i < 1000; ++i) {
+            array.pop_front();
+            array.emplace_back(i, "element with a long enough name", 0.0);
+        }
+        EXPECT_EQ(resource.allocated_blocks_count(), blocks);
+        EXPECT_EQ(array.size(), 16u);
+        EXPECT_EQ(array.front().id, 984);
+        EXPECT_EQ(array.back().id, 999);
+        
+        // Копия элемента того же типа записывается присваиванием
+        ComplexType value(5, "copy", 5.0);
+        array.pop_back();
+        array.push_back(value);
+        EXPECT_EQ(array.back().name, "copy");
+        EXPECT_EQ(resource.allocated_blocks_count(), blocks);
+    }
+    EXPECT_EQ(resource.allocated_blocks_count(), 0);
+}
+
+TEST(RecyclingPoolTest, PoolIsBoundedAndReleasable) {
+    DynamicBlockMemoryResource resource;
+    resource.set_logging(false);
+    DynamicArray<int> array{std::pmr::polymorphic_allocator<int>(&resource)};
+    for (int i = 0; i < 10; ++i) {
+        array.push_back(i);
+    }
+    array.set_recycling(4);
+    array.clear();
+    EXPECT_EQ(array.pooled(), 4u);
+    EXPECT_EQ(resource.allocated_blocks_count(), 4);
+    
+    array.push_back(42);
+    EXPECT_EQ(array.pooled(), 3u);
+    EXPECT_EQ(array.front(), 42);
+    
+    array.set_recycling(1);
+    EXPECT_EQ(array.pooled(), 1u);
+    EXPECT_EQ(resource.allocated_blocks_count(), 2);
+    
+    array.release_pool();
+    EXPECT_EQ(array.pooled(), 0u);
+    EXPECT_EQ(array.recycling_limit(), 1u);
+    EXPECT_EQ(resource.allocated_blocks_count(), 1);
+    
+    array.set_recycling(0);
+    array.pop_back();
+    EXPECT_EQ(array.pooled(), 0u);
+    EXPECT_EQ(resource.allocated_blocks_count(), 0);
+}
+
+TEST(RecyclingPoolTest, RangeAppendDrainsPoolBeforeBulkAllocation) {
+    DynamicBlockMemoryResource resource;
+    resource.set_logging(false);
+    DynamicArray<int> array{std::pmr::polymorphic_allocator<int>(&resource)};
+    array.set_recycling(8);
+    for (int i = 0; i < 8; ++i) {
+        array.push_back(i);
+    }
+    array.clear();
+    EXPECT_EQ(array.pooled(), 8u);
+    EXPECT_EQ(resource.allocated_blocks_count(), 8);
+    
+    // Копия из 10 элементов занимает 8 узлов пула и выделяет только 2 блока
+    DynamicArray<int> source{0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+    array = source;
+    EXPECT_EQ(to_vector(array), to_vector(source));
+    EXPECT_EQ(array.pooled(), 0u);
+    EXPECT_EQ(resource.allocated_blocks_count(), 10);
+    
+    // Вставка диапазона тоже сначала расходует пул
+    array.pop_front();
+    array.pop_front();
+    array.pop_front();
+    std::vector<int> inserted{10, 20, 30, 40, 50};
+    array.insert_after(array.cbegin(), inserted.begin(), inserted.end());
+    EXPECT_EQ(to_vector(array), (std::vector<int>{3, 10, 20, 30, 40, 50, 4, 5, 6, 7, 8, 9}));
+    EXPECT_EQ(array.pooled(), 0u);
+    EXPECT_EQ(resource.allocated_blocks_count(), 12);
+}
+
+
+// ==================== Тесты для политик DynamicArray ====================
+TEST(DynamicArrayPoliciesTest, DefaultsKeepPolymorphicAllocator) {
+    static_assert(std::is_same_v<DynamicArray<int>::allocator_type,
+                                 std::pmr::polymorphic_allocator<int>>);
+    static_assert(std::is_same_v<DynamicArray<int, CacheLineLayout>::allocator_type,
+                                 std::pmr::polymorphic_allocator<int>>);
+    static_assert(std::is_same_v<DynamicArray<int, UncheckedAccess, StdAllocation>::allocator_type,
+                                 std::allocator<int>>);
+    static_assert(valid_policies_v<StdAllocation, ElementGrowth, CacheLineLayout, UncheckedAccess>);
+    static_assert(!valid_policies_v<StdAllocation, PmrAllocation>);
+    static_assert(!valid_policies_v<int>);
+    
+    DynamicArray<int> array;
+    EXPECT_THROW(array.front(), std::out_of_range);
+    EXPECT_THROW(array.pop_back(), std::out_of_range);
+}
+
+TEST(DynamicArrayPoliciesTest, StdAllocation) {
+    DynamicArray<int, StdAllocation> array{1, 2, 3};
+    array.push_back(4);
+    array.push_front(0);
+    EXPECT_EQ(to_vector(array), (std::vector<int>{0, 1, 2, 3, 4}));
+    
+    DynamicArray<int, StdAllocation> copy(array);
+    copy.pop_back();
+    copy.compact();
+    EXPECT_EQ(to_vector(copy), (std::vector<int>{0, 1, 2, 3}));
+    EXPECT_EQ(array.size(), 5u);
+    EXPECT_THROW((DynamicArray<int, StdAllocation>().back()), std::out_of_range);
+}
+
+TEST(DynamicArrayPoliciesTest, MonotonicArenaAllocation) {
+    using ArenaArray = DynamicArray<int, ResourceAllocation<MonotonicArena>, UncheckedAccess>;
+    MonotonicArena arena(1 << 16);
+    arena.deallocate(arena.allocate(1), 1);   // первый блок арены берётся заранее
+    const std::size_t reserved = arena.allocated_bytes();
+    {
+        ArenaArray array{ResourceAllocator<int, MonotonicArena>(&arena)};
+        HeapAllocationCounter heap;
+        for (int i = 0; i < 100; ++i) {
+            array.push_back(i);
+        }
+        // И элементы, и узлы (три указателя) выделяются в арене, не в куче
+        EXPECT_EQ(heap.allocations, 0u);
+        EXPECT_EQ(arena.allocated_bytes() - reserved, 100 * (sizeof(int) + 3 * sizeof(void*)));
+        EXPECT_EQ(array.get_allocator().resource(), &arena);
+        
+        ArenaArray copy(array);
+        EXPECT_EQ(heap.allocations, 0u);
+        EXPECT_EQ(arena.allocated_bytes() - reserved, 200 * (sizeof(int) + 3 * sizeof(void*)));
+        EXPECT_EQ(to_vector(copy), to_vector(array));
+        
+        array.pop_front();
+        EXPECT_EQ(array.front(), 1);
+    }
+    arena.release();
+    EXPECT_EQ(arena.allocated_bytes(), 0u);
+}
+
+TEST(DynamicArrayPoliciesTest, ResourceAllocatorPropagatesDeallocationErrors) {
+    DynamicBlockMemoryResource resource;
+    resource.set_logging(false);
+    ResourceAllocator<int, DynamicBlockMemoryResource> allocator(&resource);
+    int value = 0;
+    EXPECT_THROW(allocator.deallocate(&value, 1), std::runtime_error);
+}
+
+TEST(DynamicArrayPoliciesTest, ElementGrowthSkipsBulkAllocation) {
+    DynamicBlockMemoryResource resource;
+    resource.set_logging(false);
+    std::vector<int> source(100, 7);
+    
+    DynamicArray<int> batched(source.begin(), source.end(), &resource);
+    EXPECT_EQ(resource.upstream_blocks_count(), 1);
+    
+    DynamicArray<int, ElementGrowth> single(source.begin(), source.end(), &resource);
+    EXPECT_EQ(resource.upstream_blocks_count(), 101);
+    EXPECT_EQ(to_vector(single), source);
+    
+    single.clear();
+    batched.clear();
+    EXPECT_EQ(resource.upstream_blocks_count(), 0);
+}
+
+// ==================== Тесты бюджета выделений памяти ====================
+TEST(CountingMemoryResourceTest, CountsAndChecksDeallocations) {
+    CountingMemoryResource resource;
+    void* first = resource.allocate(24, 8);
+    void* second = resource.allocate(100, 16);
+    EXPECT_EQ(resource.allocations(), 2u);
+    EXPECT_EQ(resource.live_bytes(), 124u);
+    
+    auto before = resource.counters();
+    resource.deallocate(first, 24, 8);
+    auto delta = resource.counters() - before;
+    EXPECT_EQ(delta.allocations, 0u);
+    EXPECT_EQ(delta.deallocations, 1u);
+    EXPECT_EQ(delta.bytes_deallocated, 24u);
+    
+    EXPECT_THROW(resource.deallocate(second, 200, 16), std::runtime_error);
+    resource.deallocate(second, 100, 16);
+    EXPECT_THROW(resource.deallocate(second, 100, 16), std::runtime_error);
+    EXPECT_EQ(resource.live_blocks(), 0u);
+    EXPECT_EQ(resource.peak_bytes(), 124u);
+    
+    resource.set_allocation_budget(1);
+    void* last = resource.allocate(8);
+    EXPECT_THROW(static_cast<void>(resource.allocate(8)), std::bad_alloc);
+    EXPECT_EQ(resource.allocation_budget(), 0u);
+    resource.set_allocation_budget(CountingMemoryResource::unlimited);
+    resource.deallocate(last, 8);
+}
+
+TEST(AllocationBudgetTest, IntElementCostsOneBlockAndOneNode) {
+    CountingMemoryResource resource;
+    DynamicArray<int> array{std::pmr::polymorphic_allocator<int>(&resource)};
+    
+    for (int i = 0; i < 10; ++i) {
+        auto before = resource.counters();
+        HeapAllocationCounter heap;
+        array.push_back(i);
+        auto delta = resource.counters() - before;
+        EXPECT_EQ(delta.allocations, 1u);
+        EXPECT_EQ(delta.bytes_allocated, sizeof(int));
+        EXPECT_EQ(heap.allocations, 1u);
+    }
+    
+    auto before = resource.counters();
+    {
+        HeapAllocationCounter heap;
+        array.pop_back();
+        array.pop_front();
+        EXPECT_EQ(heap.allocations, 0u);
+    }
+    auto delta = resource.counters() - before;
+    EXPECT_EQ(delta.allocations, 0u);
+    EXPECT_EQ(delta.deallocations, 2u);
+    EXPECT_EQ(delta.bytes_deallocated, 2 * sizeof(int));
+    
+    array.clear();
+    EXPECT_EQ(resource.live_blocks(), 0u);
+    EXPECT_EQ(resource.live_bytes(), 0u);
+}
+
+TEST(AllocationBudgetTest, ComplexTypeInsertionCosts) {
+    ComplexType::set_logging(false);
+    CountingMemoryResource resource;
+    CountingMemoryResource other;
+    const std::string name(40, 'n');
+    // Элемент, строка name (с завершающим нулём) и вектор data из трёх int
+    const std::size_t element_bytes = sizeof(ComplexType) + name.size() + 1 + 3 * sizeof(int);
+    {
+        DynamicArray<ComplexType> array{std::pmr::polymorphic_allocator<ComplexType>(&resource)};
+        
+        auto before = resource.counters();
+        array.emplace_back(1, name, 1.0);
+        auto delta = resource.counters() - before;
+        EXPECT_EQ(delta.allocations, 3u);
+        EXPECT_EQ(delta.bytes_allocated, element_bytes);
+        
+        // Перемещение из того же ресурса забирает строку и вектор
+        ComplexType local(2, name, 2.0, &resource);
+        before = resource.counters();
+        array.push_back(std::move(local));
+        delta = resource.counters() - before;
+        EXPECT_EQ(delta.allocations, 1u);
+        EXPECT_EQ(delta.bytes_allocated, sizeof(ComplexType));
+        
+        // Копия и перемещение из чужого ресурса копируют всё в ресурс массива
+        ComplexType foreign(3, name, 3.0, &other);
+        before = resource.counters();
+        array.push_back(foreign);
+        array.push_back(std::move(foreign));
+        delta = resource.counters() - before;
+        EXPECT_EQ(delta.allocations, 6u);
+        EXPECT_EQ(delta.bytes_allocated, 2 * element_bytes);
+        EXPECT_EQ(other.allocations(), 2u);
+        
+        before = resource.counters();
+        array.pop_back();
+        delta = resource.counters() - before;
+        EXPECT_EQ(delta.deallocations, 3u);
+        EXPECT_EQ(delta.bytes_deallocated, element_bytes);
+    }
+    EXPECT_EQ(resource.live_blocks(), 0u);
+    ComplexType::set_logging(true);
+}
+
+TEST(AllocationBudgetTest, CopyMoveAndCompactCosts) {
+    CountingMemoryResource upstream;
+    DynamicBlockMemoryResource resource(&upstream);
+    resource.set_logging(false);
+    DynamicArray<int> array{std::pmr::polymorphic_allocator<int>(&resource)};
+    for (int i = 0; i < 3000; ++i) {
+        array.push_back(i);
+    }
+    EXPECT_EQ(upstream.allocations(), 3000u);
+    
+    {
+        // Обычная копия: узлы вместе с элементами - три пачки allocate_bulk;
+        // в куче только по записи с битовой картой на каждую область в учёте ресурса
+        auto before = upstream.counters();
+        HeapAllocationCounter heap;
+        DynamicArray<int> copy(array);
+        EXPECT_EQ((upstream.counters() - before).allocations, 3u);
+        EXPECT_EQ(heap.allocations, 3u * 2);
+
+        
+        // Перемещение не выделяет ничего
+        auto moved_before = upstream.counters();
+        HeapAllocationCounter moved_heap;
+        DynamicArray<int> moved(std::move(copy));
+        EXPECT_EQ((upstream.counters() - moved_before).allocations, 0u);
+        EXPECT_EQ(moved_heap.allocations, 0u);
+    }
+    
+    array.set_copy_on_write(true);
+    {
+        // Копия copy-on-write выделяет только общий счётчик владельцев
+        auto before = upstream.counters();
+        HeapAllocationCounter heap;
+        DynamicArray<int> first(array);
+        DynamicArray<int> second(array);
+        EXPECT_EQ((upstream.counters() - before).allocations, 0u);
+        EXPECT_EQ(heap.allocations, 1u);
+    }
+    array.set_copy_on_write(false);
+    
+    {
+        // compact(): один плотный блок, узлы располагаются в нём же; в куче
+        // только запись о блоке в учёте ресурса
+        auto before = upstream.counters();
+        HeapAllocationCounter heap;
+        array.compact();
+        auto delta = upstream.counters() - before;
+        EXPECT_EQ(delta.allocations, 1u);
+        EXPECT_EQ(delta.deallocations, 3000u);
+        EXPECT_EQ(heap.allocations, 1u);
+    }
+    
+    array.clear();
+    EXPECT_EQ(upstream.live_blocks(), 0u);
+}
+
+TEST(AllocationBudgetTest, RecycledChurnStaysWithinBudget) {
+    ComplexType::set_logging(false);
+    CountingMemoryResource resource;
+    {
+        DynamicArray<ComplexType> array{std::pmr::polymorphic_allocator<ComplexType>(&resource)};
+        array.set_recycling(4);
+        for (int i = 0; i < 4; ++i) {
+            array.emplace_back(i, "a name longer than the small string buffer", 0.0);
+        }
+        
+        // Ни одного выделения: лишнее превратилось бы в std::bad_alloc
+        resource.set_allocation_budget(0);
+        HeapAllocationCounter heap;
+        for (int i = 4; i < 1000; ++i) {
+            array.pop_front();
+            array.emplace_back(i, "a name longer than the small string buffer", 0.0);
+        }
+        EXPECT_EQ(heap.allocations, 0u);
+        resource.set_allocation_budget(CountingMemoryResource::unlimited);
+        EXPECT_EQ(array.back().id, 999);
+    }
+    EXPECT_EQ(resource.live_blocks(), 0u);
+    ComplexType::set_logging(true);
+}
+
 // ==================== Интеграционные тесты ====================
 TEST(IntegrationTest, DynamicArrayWithCustomMemoryResource) {
     DynamicBlockMemoryResource resource;
@@ -423,7 +2083,8 @@ TEST(IntegrationTest, ComplexTypeWithDynamicArrayAndMemoryResource) {
         array.push_back(ComplexType(3, "Three", 3.3));
         
         EXPECT_EQ(array.size(), 3);
-        EXPECT_EQ(resource.allocated_blocks_count(), 3);
+        // Элемент и его вектор data; короткие имена не выделяют память (SSO)
+        EXPECT_EQ(resource.allocated_blocks_count(), 6);
         
         auto it = array.begin();
         ++it;
@@ -435,6 +2096,31 @@ TEST(IntegrationTest, ComplexTypeWithDynamicArrayAndMemoryResource) {
     EXPECT_EQ(resource.allocated_blocks_count(), 0);
 }
 
+TEST(IntegrationTest, ComplexTypeGraphLivesInContainerResource) {
+    DynamicBlockMemoryResource resource;
+    resource.set_logging(false);
+    std::pmr::polymorphic_allocator<ComplexType> alloc(&resource);
+    
+    {
+        DynamicArray<ComplexType> array(alloc);
+        array.emplace_back(1, "First element with a long name", 1.0);
+        array.push_back(ComplexType(2, "Second element with a long name", 2.0));
+        
+        // Элемент, имя и data каждого объекта выделены в ресурсе контейнера
+        EXPECT_EQ(resource.allocated_blocks_count(), 6);
+        for (const auto& item : array) {
+            EXPECT_EQ(item.name.get_allocator().resource(), &resource);
+            EXPECT_EQ(item.data.get_allocator().resource(), &resource);
+        }
+        
+        DynamicArray<ComplexType> copy(array);
+        EXPECT_EQ(copy.front().get_allocator().resource(), &resource);
+        EXPECT_EQ(resource.allocated_blocks_count(), 12);
+    }
+    
+    EXPECT_EQ(resource.allocated_blocks_count(), 0);
+}
+
 TEST(IntegrationTest, MemoryReuseInDynamicArray) {
     DynamicBlockMemoryResource resource;
     std::pmr::polymorphic_allocator<int> alloc(&resource);